@@ -0,0 +1,19 @@
+include(FetchContent)
+
+FetchContent_Declare(
+	lz4
+	GIT_REPOSITORY https://github.com/lz4/lz4.git
+	GIT_TAG v1.10.0
+	GIT_SUBMODULES_RECURSE  OFF
+)
+FetchContent_MakeAvailable(lz4)
+
+set(FILES
+    ${lz4_SOURCE_DIR}/lib/lz4.c
+    ${lz4_SOURCE_DIR}/lib/lz4hc.c
+    ${lz4_SOURCE_DIR}/lib/lz4frame.c
+    ${lz4_SOURCE_DIR}/lib/xxhash.c
+)
+
+add_library(lz4_static STATIC ${FILES})
+target_include_directories(lz4_static PUBLIC ${lz4_SOURCE_DIR}/lib)
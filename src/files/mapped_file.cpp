@@ -0,0 +1,168 @@
+#include "mapped_file.hpp"
+
+namespace big
+{
+	mapped_file::~mapped_file()
+	{
+		close();
+	}
+
+	bool mapped_file::open(const std::filesystem::path& path)
+	{
+		close();
+
+		// Same sharing as std::ifstream.
+		m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		LARGE_INTEGER size{};
+		if (m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &size))
+		{
+			close();
+			return false;
+		}
+
+		m_is_writable = false;
+		m_size        = size.QuadPart;
+		if (!map())
+		{
+			close();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool mapped_file::create(const std::filesystem::path& path, uint64_t size)
+	{
+		close();
+
+		// Mapping a file writable needs read access to it too.
+		m_file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (m_file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		m_is_writable = true;
+		if (!resize(size))
+		{
+			close();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool mapped_file::resize(uint64_t size)
+	{
+		if (!m_is_writable || m_file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		// A file can't change size while a view of it exists.
+		unmap();
+
+		LARGE_INTEGER end{};
+		end.QuadPart = static_cast<LONGLONG>(size);
+		if (!SetFilePointerEx(m_file, end, nullptr, FILE_BEGIN) || !SetEndOfFile(m_file))
+		{
+			return false;
+		}
+
+		m_size = size;
+		return map();
+	}
+
+	void mapped_file::close()
+	{
+		unmap();
+
+		if (m_file != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(m_file);
+			m_file = INVALID_HANDLE_VALUE;
+		}
+	}
+
+	bool mapped_file::is_open() const
+	{
+		return m_file != INVALID_HANDLE_VALUE;
+	}
+
+	char* mapped_file::data()
+	{
+		return m_data;
+	}
+
+	const char* mapped_file::data() const
+	{
+		return m_data;
+	}
+
+	uint64_t mapped_file::size() const
+	{
+		return m_size;
+	}
+
+	std::string_view mapped_file::view() const
+	{
+		return {m_data, static_cast<size_t>(m_size)};
+	}
+
+	bool mapped_file::guard_access(const std::function<void()>& access)
+	{
+		// No object needing unwinding can live in this frame.
+		__try
+		{
+			access();
+			return true;
+		}
+		__except (GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH)
+		{
+			return false;
+		}
+	}
+
+	bool mapped_file::map()
+	{
+		// Empty files can't be mapped, there is nothing to map anyway.
+		if (!m_size)
+		{
+			return true;
+		}
+
+		m_mapping = CreateFileMappingW(m_file, nullptr, m_is_writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+		if (!m_mapping)
+		{
+			m_size = 0;
+			return false;
+		}
+
+		m_data = static_cast<char*>(MapViewOfFile(m_mapping, m_is_writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+		if (!m_data)
+		{
+			unmap();
+			return false;
+		}
+
+		return true;
+	}
+
+	void mapped_file::unmap()
+	{
+		if (m_data)
+		{
+			UnmapViewOfFile(m_data);
+			m_data = nullptr;
+		}
+
+		if (m_mapping)
+		{
+			CloseHandle(m_mapping);
+			m_mapping = nullptr;
+		}
+
+		m_size = 0;
+	}
+} // namespace big
@@ -0,0 +1,50 @@
+#pragma once
+
+namespace big
+{
+	// A whole file mapped in memory: reads and writes go straight through the page cache, without the copies of stream buffers.
+	// Writes reach the disk lazily once unmapped, a failure past that point isn't reported.
+	// An I/O error while the mapping is accessed raises EXCEPTION_IN_PAGE_ERROR, which crashes the game unless the access runs through guard_access.
+	class mapped_file
+	{
+	public:
+		mapped_file() = default;
+		~mapped_file();
+
+		mapped_file(const mapped_file&)            = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		// Read-only. Empty files open fine, with nothing mapped.
+		bool open(const std::filesystem::path& path);
+
+		// Creates the file, or truncates it, at size bytes, mapped writable.
+		bool create(const std::filesystem::path& path, uint64_t size);
+
+		// Writable files only. Grows or shrinks the file, keeping the bytes within both sizes. The mapping may move.
+		// On failure nothing is mapped anymore.
+		bool resize(uint64_t size);
+
+		void close();
+
+		bool is_open() const;
+
+		char* data();
+		const char* data() const;
+		uint64_t size() const;
+		std::string_view view() const;
+
+		// Runs access, and returns false rather than crashing if an I/O error hit one of the mappings it accessed.
+		// Destructors between the fault and this call don't run, what access was building is left half done.
+		static bool guard_access(const std::function<void()>& access);
+
+	private:
+		bool map();
+		void unmap();
+
+		HANDLE m_file      = INVALID_HANDLE_VALUE;
+		HANDLE m_mapping   = nullptr;
+		char* m_data       = nullptr;
+		uint64_t m_size    = 0;
+		bool m_is_writable = false;
+	};
+} // namespace big
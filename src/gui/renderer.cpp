@@ -10,6 +10,7 @@
 #include <backends/imgui_impl_win32.h>
 #include <d3d12.h>
 #include <dxgi1_4.h>
+#include <hades2/hades2_signatures.hpp>
 #include <lua/lua_manager.hpp>
 #include <memory/gm_address.hpp>
 #include <typeinfo>
@@ -673,7 +674,7 @@ namespace big
 
 		hooking::detour_hook_helper::add<hook_sgg_scriptmanager_update_for_imgui_callbacks>(
 		    "SGG Script Manager Update - ImGui Callbacks",
-		    gmAddress::scan("4C 3B D6 74 3A", "SGG Script Manager Update").offset(-0x1'03).as<PVOID>());
+		    big::hades2_symbols::ScriptManager_Update.get());
 
 		return true;
 	}
@@ -0,0 +1,130 @@
+#include "file_stream_registry.hpp"
+
+namespace big::hades
+{
+	file_stream_registry::shard& file_stream_registry::get_shard(const void* file_stream) const
+	{
+		// Heap objects are at least 16 bytes aligned, the low bits would only ever pick a few shards.
+		const auto key = reinterpret_cast<uintptr_t>(file_stream) >> 4;
+		return m_shards[(key ^ (key >> 7)) % shard_count];
+	}
+
+	std::unique_lock<std::mutex> file_stream_registry::lock(shard& shard) const
+	{
+		std::unique_lock l(shard.m_mutex, std::try_to_lock);
+		if (!l.owns_lock())
+		{
+			m_contention_count.fetch_add(1, std::memory_order_relaxed);
+			l.lock();
+		}
+
+		return l;
+	}
+
+	void file_stream_registry::set(const void* file_stream, std::string file_path)
+	{
+		auto& shard  = get_shard(file_stream);
+		const auto l = lock(shard);
+
+		if (shard.m_entries.insert_or_assign(file_stream, entry{.m_file_path = std::move(file_path)}).second)
+		{
+			m_live_entry_count.fetch_add(1, std::memory_order_relaxed);
+		}
+		m_insert_count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	bool file_stream_registry::get_file_path(const void* file_stream, std::string& output) const
+	{
+		auto& shard  = get_shard(file_stream);
+		const auto l = lock(shard);
+
+		const auto it = shard.m_entries.find(file_stream);
+		if (it != shard.m_entries.end())
+		{
+			output.assign(it->second.m_file_path);
+			return true;
+		}
+
+		return false;
+	}
+
+	void file_stream_registry::set_patched_data(const void* file_stream, std::shared_ptr<const std::string> patched_data)
+	{
+		auto& shard  = get_shard(file_stream);
+		const auto l = lock(shard);
+
+		const auto it = shard.m_entries.find(file_stream);
+		if (it != shard.m_entries.end())
+		{
+			it->second.m_patched_size = patched_data->size();
+			it->second.m_patched_data = std::move(patched_data);
+			it->second.m_read_offset  = 0;
+		}
+	}
+
+	std::optional<size_t> file_stream_registry::get_patched_size(const void* file_stream) const
+	{
+		auto& shard  = get_shard(file_stream);
+		const auto l = lock(shard);
+
+		const auto it = shard.m_entries.find(file_stream);
+		if (it != shard.m_entries.end())
+		{
+			return it->second.m_patched_size;
+		}
+
+		return std::nullopt;
+	}
+
+	std::optional<size_t> file_stream_registry::read_patched_data(const void* file_stream, void* output, size_t size)
+	{
+		auto& shard  = get_shard(file_stream);
+		const auto l = lock(shard);
+
+		const auto it = shard.m_entries.find(file_stream);
+		if (it == shard.m_entries.end() || !it->second.m_patched_size)
+		{
+			return std::nullopt;
+		}
+
+		// Everything got read already, the file end is served rather than the original bytes.
+		auto& entry = it->second;
+		if (!entry.m_patched_data)
+		{
+			return 0;
+		}
+
+		const auto read_size = std::min(size, entry.m_patched_data->size() - entry.m_read_offset);
+		memcpy(output, entry.m_patched_data->data() + entry.m_read_offset, read_size);
+		entry.m_read_offset += read_size;
+
+		if (entry.m_read_offset == entry.m_patched_data->size())
+		{
+			entry.m_patched_data.reset();
+		}
+
+		return read_size;
+	}
+
+	void file_stream_registry::erase(const void* file_stream)
+	{
+		auto& shard  = get_shard(file_stream);
+		const auto l = lock(shard);
+
+		if (shard.m_entries.erase(file_stream))
+		{
+			m_live_entry_count.fetch_sub(1, std::memory_order_relaxed);
+			m_erase_count.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	file_stream_registry::stats file_stream_registry::get_stats() const
+	{
+		return {
+		    .m_live_entry_count = m_live_entry_count.load(std::memory_order_relaxed),
+		    .m_contention_count = m_contention_count.load(std::memory_order_relaxed),
+		    .m_insert_count     = m_insert_count.load(std::memory_order_relaxed),
+		    .m_erase_count      = m_erase_count.load(std::memory_order_relaxed),
+		};
+	}
+} // namespace big::hades
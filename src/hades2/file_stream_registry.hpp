@@ -0,0 +1,66 @@
+#pragma once
+
+namespace big::hades
+{
+	// Which file each live game FileStream object got opened on, and the patched content to serve instead of the file one when there is some.
+	// Striped over independently locked shards so that streams opened from different loading threads rarely wait on each other.
+	class file_stream_registry
+	{
+	public:
+		struct stats
+		{
+			size_t m_live_entry_count = 0;
+			// Times a shard lock was already held by another thread.
+			uint64_t m_contention_count = 0;
+			uint64_t m_insert_count     = 0;
+			uint64_t m_erase_count      = 0;
+		};
+
+		// file_path is UTF-8, as handed to the game file functions.
+		void set(const void* file_stream, std::string file_path);
+		// Assigned into output, so that a string reused from one call to the next doesn't allocate.
+		bool get_file_path(const void* file_stream, std::string& output) const;
+
+		// Shared rather than copied, the same output may be kept to be served again by a later load.
+		void set_patched_data(const void* file_stream, std::shared_ptr<const std::string> patched_data);
+		std::optional<size_t> get_patched_size(const void* file_stream) const;
+
+		// Copies the next bytes of the patched data, nullopt if the stream has none.
+		// The bytes are dropped once everything got read, the stream keeps reporting the patched size until it gets erased.
+		std::optional<size_t> read_patched_data(const void* file_stream, void* output, size_t size);
+
+		// Call it once the stream is done with, or is about to be reused for another file.
+		void erase(const void* file_stream);
+
+		stats get_stats() const;
+
+	private:
+		static constexpr size_t shard_count = 16;
+
+		struct entry
+		{
+			std::string m_file_path;
+			std::shared_ptr<const std::string> m_patched_data;
+			// Set along with m_patched_data, and kept once it got read and dropped.
+			std::optional<size_t> m_patched_size;
+			size_t m_read_offset = 0;
+		};
+
+		struct alignas(std::hardware_destructive_interference_size) shard
+		{
+			mutable std::mutex m_mutex;
+			std::unordered_map<const void*, entry> m_entries;
+		};
+
+		shard& get_shard(const void* file_stream) const;
+		std::unique_lock<std::mutex> lock(shard& shard) const;
+
+		mutable std::array<shard, shard_count> m_shards;
+		std::atomic<size_t> m_live_entry_count{0};
+		mutable std::atomic<uint64_t> m_contention_count{0};
+		std::atomic<uint64_t> m_insert_count{0};
+		std::atomic<uint64_t> m_erase_count{0};
+	};
+
+	inline file_stream_registry g_file_stream_registry;
+} // namespace big::hades
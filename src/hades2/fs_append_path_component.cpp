@@ -0,0 +1,112 @@
+#include "fs_append_path_component.hpp"
+
+#include "hades2/hades2_signatures.hpp"
+
+#include <deque>
+#include <hooks/hooking.hpp>
+
+namespace big::hades::fs_append_path_component
+{
+	struct handler_stats
+	{
+		std::atomic<uint64_t> m_call_count{0};
+		std::atomic<uint64_t> m_hit_count{0};
+	};
+
+	struct handler_entry
+	{
+		std::string_view m_name;
+		int32_t m_priority;
+		handler_t m_handler;
+		handler_stats* m_stats;
+	};
+
+	// Copy on write: the hook walks whatever table is current without locking, add_handler publishes a new one.
+	// Previous tables are kept alive, a path join may still be walking them and there are only ever a handful.
+	// Names and stats live in deques so the entries pointing at them stay valid across table copies.
+	static std::mutex g_registration_mutex;
+	static std::vector<std::unique_ptr<const std::vector<handler_entry>>> g_tables;
+	static std::deque<handler_stats> g_stats;
+	static std::deque<std::string> g_names;
+	static std::atomic<const std::vector<handler_entry>*> g_current_table{nullptr};
+
+	static void hook_fsAppendPathComponent(const char* base_path, const char* path_component, char* output /*size: 512*/)
+	{
+		big::g_hooking->get_original<hook_fsAppendPathComponent>()(base_path, path_component, output);
+
+		const auto table = g_current_table.load(std::memory_order_acquire);
+		if (!table)
+		{
+			return;
+		}
+
+		for (const auto& entry : *table)
+		{
+			entry.m_stats->m_call_count.fetch_add(1, std::memory_order_relaxed);
+
+			const auto res = entry.m_handler(base_path, path_component, output);
+			if (res == handler_result::pass)
+			{
+				continue;
+			}
+
+			entry.m_stats->m_hit_count.fetch_add(1, std::memory_order_relaxed);
+
+			if (res == handler_result::handled)
+			{
+				return;
+			}
+		}
+	}
+
+	void add_handler(std::string_view name, int32_t priority, handler_t handler)
+	{
+		std::scoped_lock l(g_registration_mutex);
+
+		auto table = std::make_unique<std::vector<handler_entry>>();
+		if (const auto current_table = g_current_table.load())
+		{
+			// The bindings can be bound again when the lua manager gets recreated.
+			if (std::ranges::find(*current_table, handler, &handler_entry::m_handler) != current_table->end())
+			{
+				return;
+			}
+
+			*table = *current_table;
+		}
+
+		const auto insert_it = std::ranges::upper_bound(*table, priority, {}, &handler_entry::m_priority);
+		table->insert(insert_it, handler_entry{g_names.emplace_back(name), priority, handler, &g_stats.emplace_back()});
+
+		g_current_table.store(table.get(), std::memory_order_release);
+		g_tables.push_back(std::move(table));
+	}
+
+	void init_hook()
+	{
+		static auto fsAppendPathComponent = big::hades2_symbols::fsAppendPathComponent.get();
+		if (fsAppendPathComponent)
+		{
+			static auto hook_once = big::hooking::detour_hook_helper::add<hook_fsAppendPathComponent>("fsAppendPathComponent dispatcher", fsAppendPathComponent);
+		}
+	}
+
+	void log_handler_stats()
+	{
+		const auto table = g_current_table.load(std::memory_order_acquire);
+		if (!table)
+		{
+			return;
+		}
+
+		for (const auto& entry : *table)
+		{
+			LOGF(INFO,
+			     "fsAppendPathComponent handler {} (priority {}): {} calls, {} hits",
+			     entry.m_name,
+			     entry.m_priority,
+			     entry.m_stats->m_call_count.load(std::memory_order_relaxed),
+			     entry.m_stats->m_hit_count.load(std::memory_order_relaxed));
+		}
+	}
+} // namespace big::hades::fs_append_path_component
@@ -0,0 +1,28 @@
+#pragma once
+
+namespace big::hades::fs_append_path_component
+{
+	enum class handler_result : uint8_t
+	{
+		// Didn't touch the output.
+		pass,
+		// Rewrote the output, the next handlers still run.
+		modified,
+		// Rewrote the output, the next handlers are skipped.
+		handled,
+	};
+
+	// Called after the game joined the path, output (512 bytes) holds the game result or what a previous handler rewrote it to.
+	using handler_t = handler_result (*)(const char* base_path, const char* path_component, char* output);
+
+	// Handlers run by ascending priority, registration order breaks ties.
+	// Can be called at any time from any thread, path joins happening concurrently keep using the previous table.
+	// Registering the same handler twice is a no-op.
+	void add_handler(std::string_view name, int32_t priority, handler_t handler);
+
+	// The single detour of the game fsAppendPathComponent, every handler goes through it. Call it once before hooks get enabled.
+	void init_hook();
+
+	// Per handler call and hit (modified or handled) counts.
+	void log_handler_stats();
+} // namespace big::hades::fs_append_path_component
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "signatures/signatures.hpp"
+
+namespace big
+{
+	namespace hades2_signatures_table
+	{
+		using enum signatures::resolve_stage;
+		using enum signatures::address_fixup;
+
+		// Every game symbol, declared once and resolved all at once by signatures::run_startup_batch.
+		// Fetch them through the hades2_symbols handles below (or signatures::get by name) instead of scanning again.
+		// Symbols only used once the main thread is up (or lazily from game hooks) are deferred so that they get scanned in parallel.
+		// clang-format off
+		inline constexpr signatures::signature table[] = {
+			// Hooked from DllMain
+			{"initRenderer",                                        "E8 ? ? ? ? 90 48 8B 05 ? ? ? ? 48 85 C0",     loader,   0,        get_call},
+			{"backtrace::initializeCrashpad",                       "74 13 48 8B C8",                              loader,   -0x4C},
+			{"sgg::GUIComponentTextBox::Update",                    "76 30 8B 43 74",                              loader,   -0x51},
+			{"sgg::GUIComponentTextBox::GUIComponentTextBox_dctor", "8D 05 ? ? ? ? 48 8B F1 4C 8D B1",             loader,   -0x19},
+			{"sgg::GUIComponentButton::OnSelected",                 "8B D9 E8 ? ? ? ? 80 BB AA",                   loader,   -0x7},
+			{"ReadAllAnimationData",                                "BA 2A 00 00 00",                              loader,   -0x1'97},
+			{"Player HandleInput",                                  "E8 ? ? ? ? 8B 05 ? ? ? ? 90",                 loader},
+			{"registerField<bool>",                                 "4C 8B C1 88 5C 24 38",                        loader,   -0x2B},
+			{"Analy Start",                                         "4C 8B DC 48 83 EC 48 80 3D",                  loader},
+			{"sgg::LaunchBugReporter",                              "E8 ? ? ? ? B8 ? ? ? ? EB 05",                 loader,   0,        get_call},
+			{"fsGetFilesWithExtension",                             "E8 ? ? ? ? 48 8B 7D CF",                      loader,   0,        get_call},
+			{"fsAppendPathComponent",                               "C6 44 24 30 5C",                              loader,   -0x97},
+
+			// Called from the main.cpp game hooks
+			{"hades_luaH_free",                                     "E8 ?? ?? ?? ?? E9 AB 00 00 00 48 8B D3",      deferred, 0,        get_call},
+			{"hades_luaH_getn",                                     "48 8B E9 85 DB",                              deferred, -0xD},
+			{"hades_luaH_new",                                      "44 8D 43 40 E8",                              deferred, -0x12},
+			{"hades_luaH_newkey",                                   "83 F8 03 75 15",                              deferred, -0x25},
+			{"hades_luaH_resize",                                   "44 3B EF 7E 6A",                              deferred, -0x47},
+			{"hades_luaH_resizearray",                              "E8 ?? ?? ?? ?? 4C 63 FB",                     deferred, 0,        get_call},
+			{"hades_setnodevector",                                 "45 85 C0 75 15",                              deferred, -0x1E},
+			{"Player HandleInput GUI Jump",                         "74 7C 38 05",                                 deferred},
+
+			// hades2/hooks.hpp, hades2/hades_lua.hpp
+			{"game logger",                                         "8B D1 83 E2 08",                              deferred, -0x2C},
+			{"BacktraceHandleException",                            "B8 B0 FC 00 00",                              deferred, -0x20},
+			{"sgg_ForgeRenderer_PrintErrorMessageAndAssert",        "48 63 44 24 34",                              deferred, -0x97},
+			{"lua_pcallk",                                          "75 05 44 8B D6",                              deferred, -0x1D},
+			{"ScriptManager_Load",                                  "49 3B DF 76 29",                              deferred, -0x6E},
+
+			// gui/renderer.cpp
+			{"SGG Script Manager Update",                           "4C 3B D6 74 3A",                              deferred, -0x1'03},
+
+			// lua_extensions/bindings
+			{"ReadGameData",                                        "7D 70 4C 8D 05",                              deferred, -0x7B},
+			{"gStringBuffer",                                       "4C 03 0D ? ? ? ? 48 8B DA 0F B6 54 24",       deferred, 3,        rip},
+			{"FileStreamOpen",                                      "44 8B C9 33 D2",                              deferred, -0x97},
+			{"FileStreamRead",                                      "48 3B C3 74 42",                              deferred, -0x2D},
+			{"RegisterDebugKey",                                    "E8 ? ? ? ? 90 48 8B 45 DF",                   deferred, 0,        get_call},
+			{"sgg::AudioManager::LoadBank",                         "90 84 C0 75 2B",                              deferred, -0x2B},
+			{"sgg::GUIComponentTextBox::GetLocation",               "F3 0F 59 4A 48",                              deferred, -0xBE},
+			{"GetActiveThing",                                      "C3 48 8B 40 08",                              deferred, -0x5C},
+		};
+		// clang-format on
+
+		// A typo in a handle name fails the build instead of failing the lookup at runtime.
+		template<typename T = void>
+		consteval signatures::symbol<T> make_symbol(std::string_view name)
+		{
+			for (const auto& sig : table)
+			{
+				if (sig.m_name == name)
+				{
+					return {name};
+				}
+			}
+
+			throw "Unknown hades2 symbol name.";
+		}
+	} // namespace hades2_signatures_table
+
+	inline constexpr auto& hades2_signatures = hades2_signatures_table::table;
+
+	// Typed handles to the symbols of the table above.
+	// Symbols whose types only exist in the file using them stay untyped, use address().as_func<...>() there.
+	namespace hades2_symbols
+	{
+		using hades2_signatures_table::make_symbol;
+
+		// clang-format off
+		inline constexpr auto initRenderer                    = make_symbol("initRenderer");
+		inline constexpr auto initializeCrashpad              = make_symbol<bool()>("backtrace::initializeCrashpad");
+		inline constexpr auto GUIComponentTextBox_Update      = make_symbol("sgg::GUIComponentTextBox::Update");
+		inline constexpr auto GUIComponentTextBox_dctor       = make_symbol("sgg::GUIComponentTextBox::GUIComponentTextBox_dctor");
+		inline constexpr auto GUIComponentButton_OnSelected   = make_symbol("sgg::GUIComponentButton::OnSelected");
+		inline constexpr auto ReadAllAnimationData            = make_symbol<void()>("ReadAllAnimationData");
+		inline constexpr auto PlayerHandleInput               = make_symbol("Player HandleInput");
+		inline constexpr auto registerField_bool              = make_symbol("registerField<bool>");
+		inline constexpr auto PlatformAnalytics_Start         = make_symbol("Analy Start");
+		inline constexpr auto LaunchBugReporter               = make_symbol("sgg::LaunchBugReporter");
+		inline constexpr auto fsGetFilesWithExtension         = make_symbol("fsGetFilesWithExtension");
+		inline constexpr auto fsAppendPathComponent           = make_symbol<void(const char*, const char*, char*)>("fsAppendPathComponent");
+
+		inline constexpr auto luaH_free                       = make_symbol("hades_luaH_free");
+		inline constexpr auto luaH_getn                       = make_symbol("hades_luaH_getn");
+		inline constexpr auto luaH_new                        = make_symbol("hades_luaH_new");
+		inline constexpr auto luaH_newkey                     = make_symbol("hades_luaH_newkey");
+		inline constexpr auto luaH_resize                     = make_symbol("hades_luaH_resize");
+		inline constexpr auto luaH_resizearray                = make_symbol("hades_luaH_resizearray");
+		inline constexpr auto setnodevector                   = make_symbol("hades_setnodevector");
+		inline constexpr auto PlayerHandleInput_GUIJump       = make_symbol<uint8_t>("Player HandleInput GUI Jump");
+
+		inline constexpr auto game_logger                     = make_symbol("game logger");
+		inline constexpr auto BacktraceHandleException        = make_symbol("BacktraceHandleException");
+		inline constexpr auto PrintErrorMessageAndAssert      = make_symbol("sgg_ForgeRenderer_PrintErrorMessageAndAssert");
+		inline constexpr auto lua_pcallk                      = make_symbol("lua_pcallk");
+		inline constexpr auto ScriptManager_Load              = make_symbol("ScriptManager_Load");
+		inline constexpr auto ScriptManager_Update            = make_symbol("SGG Script Manager Update");
+
+		inline constexpr auto ReadGameData                    = make_symbol<void()>("ReadGameData");
+		inline constexpr auto gStringBuffer                   = make_symbol<const char*>("gStringBuffer");
+		inline constexpr auto FileStreamOpen                  = make_symbol("FileStreamOpen");
+		inline constexpr auto FileStreamRead                  = make_symbol("FileStreamRead");
+		inline constexpr auto RegisterDebugKey                = make_symbol("RegisterDebugKey");
+		inline constexpr auto AudioManager_LoadBank           = make_symbol("sgg::AudioManager::LoadBank");
+		inline constexpr auto GUIComponentTextBox_GetLocation = make_symbol("sgg::GUIComponentTextBox::GetLocation");
+		inline constexpr auto GetActiveThing                  = make_symbol("GetActiveThing");
+		// clang-format on
+	} // namespace hades2_symbols
+} // namespace big
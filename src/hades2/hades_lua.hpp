@@ -1,9 +1,11 @@
 #pragma once
 
+#include "hades2/hades2_signatures.hpp"
 #include "hooks/hooking.hpp"
 #include "lua_extensions/lua_manager_extension.hpp"
 #include "memory/gm_address.hpp"
 #include "pointers.hpp"
+#include "profiling/startup_timeline.hpp"
 
 #include <lua_extensions/lua_manager_extension.hpp>
 #include <lua_extensions/lua_module_ext.hpp>
@@ -19,6 +21,9 @@ namespace big::hades::lua
 
 		std::scoped_lock l(lua_manager_extension::g_manager_mutex);
 
+		startup_timeline::set_thread_name("Game thread");
+		std::optional<startup_timeline::scoped_span> span(std::in_place, "phase", "Lua manager init and mods load");
+
 		lua_manager_extension::g_lua_manager_instance = std::make_unique<lua_manager>(
 		    L,
 		    g_file_manager.get_project_folder("config"),
@@ -68,6 +73,10 @@ namespace big::hades::lua
 
 		lua_manager_extension::g_is_lua_state_valid = true;
 		LOG(INFO) << "state is valid";
+
+		// Startup is over once the mods are loaded for the first time.
+		span.reset();
+		startup_timeline::finish(g_file_manager.get_project_file("./startup_timeline.json").get_path());
 	}
 
 	inline sol::optional<sol::environment> env_to_add;
@@ -136,12 +145,21 @@ namespace big::hades::lua
 
 	inline void init_hooks()
 	{
-		hooking::detour_hook_helper::add<hook_lua_pcallk>("lua_pcallk", gmAddress::scan("75 05 44 8B D6", "lua_pcallk").offset(-0x1D));
+		{
+			startup_timeline::scoped_span span("hook", "lua_pcallk");
+			hooking::detour_hook_helper::add<hook_lua_pcallk>("lua_pcallk", big::hades2_symbols::lua_pcallk.address());
+		}
 
-		hooking::detour_hook_helper::add<hook_sgg_ScriptManager_Load>(
-		    "ScriptManager_Load",
-		    gmAddress::scan("49 3B DF 76 29", "ScriptManager_Load").offset(-0x6E));
+		{
+			startup_timeline::scoped_span span("hook", "ScriptManager_Load");
+			hooking::detour_hook_helper::add<hook_sgg_ScriptManager_Load>(
+			    "ScriptManager_Load",
+			    big::hades2_symbols::ScriptManager_Load.address());
+		}
 
-		hooking::detour_hook_helper::add<hook_luaL_checkversion_>("Multiple Lua VM detected patch", luaL_checkversion_);
+		{
+			startup_timeline::scoped_span span("hook", "Multiple Lua VM detected patch");
+			hooking::detour_hook_helper::add<hook_luaL_checkversion_>("Multiple Lua VM detected patch", luaL_checkversion_);
+		}
 	}
 } // namespace big::hades::lua
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "hades2/disable_sgg_analytics/disable_sgg_analytics.hpp"
+#include "hades2/hades2_signatures.hpp"
 #include "hades2/hades_lua.hpp"
 #include "hades2/log_write.hpp"
 #include "hades2/sgg_exception_handler/disable_sgg_handler.hpp"
 #include "memory/gm_address.hpp"
+#include "profiling/startup_timeline.hpp"
 
 #include <config/config.hpp>
 
@@ -14,19 +16,28 @@ namespace big::hades
 	inline void init_hooks()
 	{
 		g_hook_log_write_enabled = big::config::general().bind("Logging", "Output Vanilla Game Log", true, "Output to the Hell2Modding log the vanilla game log Hades2.log");
-		hooking::detour_hook_helper::add<hook_log_write>("game logger",
-		                                                 gmAddress::scan("8B D1 83 E2 08", "game logger").offset(-0x2C).as<void*>());
+		{
+			startup_timeline::scoped_span span("hook", "game logger");
+			hooking::detour_hook_helper::add<hook_log_write>("game logger",
+			                                                 big::hades2_symbols::game_logger.get());
+		}
 
-		const auto backtraceHandleException = gmAddress::scan("B8 B0 FC 00 00", "BacktraceHandleException");
-		if (backtraceHandleException)
 		{
-			hooking::detour_hook_helper::add<hook_sgg_BacktraceHandleException>("Suppress SGG BacktraceHandleException",
-			                                                                    backtraceHandleException.offset(-0x20));
+			startup_timeline::scoped_span span("hook", "Suppress SGG BacktraceHandleException");
+			const auto backtraceHandleException = big::hades2_symbols::BacktraceHandleException.address();
+			if (backtraceHandleException)
+			{
+				hooking::detour_hook_helper::add<hook_sgg_BacktraceHandleException>("Suppress SGG BacktraceHandleException",
+				                                                                    backtraceHandleException);
+			}
 		}
 
-		hooking::detour_hook_helper::add<hook_sgg_ForgeRenderer_PrintErrorMessageAndAssert>(
-		    "sgg_ForgeRenderer_PrintErrorMessageAndAssert",
-		    gmAddress::scan("48 63 44 24 34", "sgg_ForgeRenderer_PrintErrorMessageAndAssert").offset(-0x97));
+		{
+			startup_timeline::scoped_span span("hook", "sgg_ForgeRenderer_PrintErrorMessageAndAssert");
+			hooking::detour_hook_helper::add<hook_sgg_ForgeRenderer_PrintErrorMessageAndAssert>(
+			    "sgg_ForgeRenderer_PrintErrorMessageAndAssert",
+			    big::hades2_symbols::PrintErrorMessageAndAssert.address());
+		}
 
 		big::hades::lua::init_hooks();
 	}
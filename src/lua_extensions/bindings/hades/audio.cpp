@@ -1,6 +1,7 @@
 #include "audio.hpp"
 
-#include <hooks/hooking.hpp>
+#include <hades2/fs_append_path_component.hpp>
+#include <hades2/hades2_signatures.hpp>
 #include <lua_extensions/bindings/tolk/tolk.hpp>
 #include <memory/gm_address.hpp>
 #include <string/string.hpp>
@@ -10,17 +11,17 @@ namespace lua::hades::audio
 	static bool need_path_fix_fsAppendPathComponent     = false;
 	static std::string fixed_path_fsAppendPathComponent = "";
 
-	static void hook_fsAppendPathComponent(const char* basePath, const char* pathComponent, char* output /*size: 512*/)
+	static big::hades::fs_append_path_component::handler_result fix_bank_path(const char* basePath, const char* pathComponent, char* output /*size: 512*/)
 	{
-		if (need_path_fix_fsAppendPathComponent)
+		if (!need_path_fix_fsAppendPathComponent)
 		{
-			LOG(INFO) << "setting path to " << fixed_path_fsAppendPathComponent;
-			strcpy(output, fixed_path_fsAppendPathComponent.c_str());
-		}
-		else
-		{
-			big::g_hooking->get_original<hook_fsAppendPathComponent>()(basePath, pathComponent, output);
+			return big::hades::fs_append_path_component::handler_result::pass;
 		}
+
+		LOG(INFO) << "setting path to " << fixed_path_fsAppendPathComponent;
+		strcpy(output, fixed_path_fsAppendPathComponent.c_str());
+
+		return big::hades::fs_append_path_component::handler_result::handled;
 	}
 
 	// Lua API: Function
@@ -35,19 +36,14 @@ namespace lua::hades::audio
 			Base = 2
 		};
 
-		static auto LoadBank_ptr = gmAddress::scan("90 84 C0 75 2B", "sgg::AudioManager::LoadBank");
+		static auto LoadBank_ptr = big::hades2_symbols::AudioManager_LoadBank.address();
 		if (LoadBank_ptr)
 		{
-			static auto LoadBank = LoadBank_ptr.offset(-0x2B).as_func<void(eastl::string_view*, sgg__PackageGroup)>();
+			static auto LoadBank = LoadBank_ptr.as_func<void(eastl::string_view*, sgg__PackageGroup)>();
 
-			static auto fsAppendPathComponent_ptr = gmAddress::scan("C6 44 24 30 5C", "fsAppendPathComponent");
-			if (fsAppendPathComponent_ptr)
+			static auto fsAppendPathComponent = big::hades2_symbols::fsAppendPathComponent.get();
+			if (fsAppendPathComponent)
 			{
-				static auto fsAppendPathComponent = fsAppendPathComponent_ptr.offset(-0x97).as_func<void(const char*, const char*, char*)>();
-
-				static auto hook_once =
-				    big::hooking::detour_hook_helper::add<hook_fsAppendPathComponent>("hook_fsAppendPathComponent", fsAppendPathComponent);
-
 				std::string bank_name = (char*)std::filesystem::path(file_path).stem().u8string().c_str();
 				eastl::string_view fp(bank_name.c_str(), bank_name.size());
 
@@ -68,5 +64,8 @@ namespace lua::hades::audio
 	{
 		auto ns = state.create_named("audio");
 		ns.set_function("load_bank", load_bank);
+
+		// Runs before anything else, the bank path replaces whatever the game joined.
+		big::hades::fs_append_path_component::add_handler("audio bank path fix", 0, fix_bank_path);
 	}
 } // namespace lua::hades::audio
@@ -0,0 +1,154 @@
+#include "byte_buffer.hpp"
+
+namespace lua::hades::byte_buffer
+{
+	byte_buffer::byte_buffer(std::string& data) :
+	    m_data(&data)
+	{
+	}
+
+	void byte_buffer::detach()
+	{
+		m_data = nullptr;
+	}
+
+	bool byte_buffer::is_modified() const
+	{
+		return m_is_modified;
+	}
+
+	std::string_view byte_buffer::get_data() const
+	{
+		return m_data ? std::string_view(*m_data) : std::string_view();
+	}
+
+	size_t byte_buffer::size() const
+	{
+		return m_data ? m_data->size() : 0;
+	}
+
+	sol::object byte_buffer::find(std::string_view pattern, sol::optional<size_t> init, sol::this_state state) const
+	{
+		const auto start = init.value_or(1);
+		if (!m_data || start == 0)
+		{
+			return sol::lua_nil;
+		}
+
+		const auto pos = std::string_view(*m_data).find(pattern, start - 1);
+		if (pos == std::string_view::npos)
+		{
+			return sol::lua_nil;
+		}
+
+		return sol::make_object(state, pos + 1);
+	}
+
+	size_t byte_buffer::replace(std::string_view pattern, std::string_view replacement, sol::optional<size_t> max_count)
+	{
+		if (!m_data || pattern.empty())
+		{
+			return 0;
+		}
+
+		const auto limit = max_count.value_or(std::numeric_limits<size_t>::max());
+
+		// Every occurrence is found first so that the bytes in between move at most once, whichever way the size changes.
+		std::vector<size_t> positions;
+		for (auto pos = m_data->find(pattern); pos != std::string::npos && positions.size() < limit; pos = m_data->find(pattern, pos + pattern.size()))
+		{
+			positions.push_back(pos);
+		}
+
+		if (positions.empty())
+		{
+			return 0;
+		}
+
+		auto& data = *m_data;
+		if (replacement.size() <= pattern.size())
+		{
+			// Front to back, the write position never passes the read position.
+			size_t write = positions.front();
+			for (size_t i = 0; i < positions.size(); i++)
+			{
+				memcpy(data.data() + write, replacement.data(), replacement.size());
+				write += replacement.size();
+
+				const auto read = positions[i] + pattern.size();
+				const auto next = i + 1 < positions.size() ? positions[i + 1] : data.size();
+				memmove(data.data() + write, data.data() + read, next - read);
+				write += next - read;
+			}
+			data.resize(write);
+		}
+		else
+		{
+			// Back to front, into the grown buffer.
+			const auto old_size = data.size();
+			data.resize(old_size + positions.size() * (replacement.size() - pattern.size()));
+
+			size_t read_end  = old_size;
+			size_t write_end = data.size();
+			for (auto it = positions.rbegin(); it != positions.rend(); ++it)
+			{
+				const auto read  = *it + pattern.size();
+				write_end       -= read_end - read;
+				memmove(data.data() + write_end, data.data() + read, read_end - read);
+
+				write_end -= replacement.size();
+				memcpy(data.data() + write_end, replacement.data(), replacement.size());
+				read_end = *it;
+			}
+		}
+
+		m_is_modified = true;
+		return positions.size();
+	}
+
+	bool byte_buffer::insert(size_t position, std::string_view bytes)
+	{
+		if (!m_data || position == 0 || position > m_data->size() + 1)
+		{
+			return false;
+		}
+
+		m_data->insert(position - 1, bytes);
+		m_is_modified = true;
+		return true;
+	}
+
+	std::string byte_buffer::slice(size_t start, sol::optional<size_t> end) const
+	{
+		if (!m_data || start == 0 || start > m_data->size())
+		{
+			return {};
+		}
+
+		const auto last = std::min(end.value_or(m_data->size()), m_data->size());
+		if (last < start)
+		{
+			return {};
+		}
+
+		return m_data->substr(start - 1, last - start + 1);
+	}
+
+	void bind(sol::table& state)
+	{
+		state.new_usertype<byte_buffer>("byte_buffer",
+		                                sol::no_constructor,
+		                                "size",
+		                                &byte_buffer::size,
+		                                sol::meta_function::length,
+		                                &byte_buffer::size,
+		                                "find",
+		                                &byte_buffer::find,
+		                                "replace",
+		                                &byte_buffer::replace,
+		                                "insert",
+		                                &byte_buffer::insert,
+		                                "slice",
+		                                &byte_buffer::slice);
+	}
+} // namespace lua::hades::byte_buffer
@@ -0,0 +1,69 @@
+#pragma once
+
+namespace lua::hades::byte_buffer
+{
+	// Lua API: Class
+	// Name: byte_buffer
+	// Mutable bytes of a game data file handed to the rom.data.on_sjson_read_as_buffer callbacks.
+	// Edits are made in place, the content is never copied into a Lua string unless slice asks for it.
+	// Positions are 1-based and inclusive, as for the Lua string functions.
+	// The buffer is only valid during the callback it was handed to.
+	class byte_buffer
+	{
+	public:
+		explicit byte_buffer(std::string& data);
+
+		// The callbacks are over, whatever a mod that held onto the object does with it afterwards is ignored.
+		void detach();
+
+		bool is_modified() const;
+
+		// Empty once detached.
+		std::string_view get_data() const;
+
+		// Lua API: Function
+		// Class: byte_buffer
+		// Name: size
+		// Returns: integer: Number of bytes in the buffer.
+		size_t size() const;
+
+		// Lua API: Function
+		// Class: byte_buffer
+		// Name: find
+		// Param: pattern: string: Bytes to look for, compared as is (no Lua pattern matching).
+		// Param: init: integer: optional. Position to start looking at, 1 if omitted.
+		// Returns: integer: Position of the first occurrence, or nil if there is none.
+		sol::object find(std::string_view pattern, sol::optional<size_t> init, sol::this_state state) const;
+
+		// Lua API: Function
+		// Class: byte_buffer
+		// Name: replace
+		// Param: pattern: string: Bytes to look for, compared as is (no Lua pattern matching).
+		// Param: replacement: string: Bytes to put instead.
+		// Param: max_count: integer: optional. Only replace the first max_count occurrences, all of them if omitted.
+		// Returns: integer: Number of occurrences replaced.
+		size_t replace(std::string_view pattern, std::string_view replacement, sol::optional<size_t> max_count);
+
+		// Lua API: Function
+		// Class: byte_buffer
+		// Name: insert
+		// Param: position: integer: Position the first inserted byte ends up at, size() + 1 appends.
+		// Param: bytes: string: Bytes to insert.
+		// Returns: boolean: True if the position was valid.
+		bool insert(size_t position, std::string_view bytes);
+
+		// Lua API: Function
+		// Class: byte_buffer
+		// Name: slice
+		// Param: start: integer: Position of the first byte.
+		// Param: end: integer: optional. Position of the last byte, the end of the buffer if omitted.
+		// Returns: string: Copy of the bytes in between.
+		std::string slice(size_t start, sol::optional<size_t> end) const;
+
+	private:
+		std::string* m_data;
+		bool m_is_modified = false;
+	};
+
+	void bind(sol::table& state);
+} // namespace lua::hades::byte_buffer
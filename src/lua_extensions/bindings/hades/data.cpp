@@ -1,171 +1,501 @@
 #include "data.hpp"
 
+#include "byte_buffer.hpp"
 #include "hades_ida.hpp"
+#include "sjson_document.hpp"
 
+#include <hades2/file_stream_registry.hpp>
+#include <hades2/fs_append_path_component.hpp>
+#include <hades2/hades2_signatures.hpp>
 #include <hooks/hooking.hpp>
 #include <lua/lua_manager.hpp>
 #include <lua_extensions/lua_module_ext.hpp>
+#include <lua_extensions/sjson_callback_index.hpp>
 #include <memory/gm_address.hpp>
-#include <string/string.hpp>
+#include <mod_files/file_existence_cache.hpp>
+#include <mod_files/patched_file_cache.hpp>
+#include <mod_files/plugins_data.hpp>
+#include <paths/paths.hpp>
+#include <sjson/merge.hpp>
+
+#define XXH_STATIC_LINKING_ONLY
+#include <xxhash.h>
 
 namespace lua::hades::data
 {
-	static std::recursive_mutex g_FileStream_to_filename_mutex;
-	static std::unordered_map<void*, std::filesystem::path> g_FileStream_to_filename;
-
-	static void* original_GetFileSize = nullptr;
-	static void* current_file_stream  = nullptr;
+	// Streams get opened from several loader threads at once, each joins the paths of its own.
+	static thread_local void* current_file_stream = nullptr;
 
 	static size_t hook_FileStreamGetFileSize(uintptr_t pFile)
 	{
-		std::scoped_lock l(g_FileStream_to_filename_mutex);
-
-		auto size = *(size_t*)(pFile + 0x20);
-
 		// Used for allocating the output buffer and the Read call.
-		auto it = g_FileStream_to_filename.find((void*)pFile);
-		if (it != g_FileStream_to_filename.end() && it->second.extension() == ".sjson")
+		if (const auto patched_size = big::hades::g_file_stream_registry.get_patched_size((void*)pFile))
 		{
-			size *= 2;
+			return *patched_size;
 		}
 
-		return size;
+		return *(size_t*)(pFile + 0x20);
 	}
 
-	static void hook_fsAppendPathComponent(const char* basePath, const char* pathComponent, char* output /*size: 512*/)
+	static bool is_absolute_path(std::string_view path)
 	{
-		big::g_hooking->get_original<hook_fsAppendPathComponent>()(basePath, pathComponent, output);
+		const auto is_separator = [](char c)
+		{
+			return c == '/' || c == '\\';
+		};
+
+		return (path.size() >= 3 && isalpha(static_cast<uint8_t>(path[0])) && path[1] == ':' && is_separator(path[2]))
+		    || (path.size() >= 2 && is_separator(path[0]) && is_separator(path[1]));
+	}
 
+	static big::hades::fs_append_path_component::handler_result track_file_stream_path(const char* basePath, const char* pathComponent, char* output /*size: 512*/)
+	{
 		if (current_file_stream && output)
 		{
-			std::filesystem::path output_ = output;
-			if (output_.is_absolute() && std::filesystem::exists(output_))
+			// Only game data files are ever looked up, see patch_game_data_file.
+			// The existence check is served from memory, this runs for every file the game opens.
+			const std::string_view output_ = output;
+			if (output_.ends_with(".sjson") && is_absolute_path(output_) && big::g_file_existence_cache.exists(output_))
 			{
-				std::scoped_lock l(g_FileStream_to_filename_mutex);
-
-				g_FileStream_to_filename[current_file_stream] = output_;
+				big::hades::g_file_stream_registry.set(current_file_stream, std::string(output_));
 			}
 		}
+
+		return big::hades::fs_append_path_component::handler_result::pass;
 	}
 
-	static bool hook_FileStreamOpen(int64_t resourceDir, const char* fileName, int64_t mode, void* file_stream)
+	static size_t hook_FileStreamRead(void* file_stream, void* outputBuffer, size_t bufferSizeInBytes)
 	{
-		current_file_stream = file_stream;
+		const auto size_read = big::hades::g_file_stream_registry.read_patched_data(file_stream, outputBuffer, bufferSizeInBytes);
+		if (!size_read)
+		{
+			return big::g_hooking->get_original<hook_FileStreamRead>()(file_stream, outputBuffer, bufferSizeInBytes);
+		}
 
-		const auto res = big::g_hooking->get_original<hook_FileStreamOpen>()(resourceDir, fileName, mode, file_stream);
-		if (res)
+		return *size_read;
+	}
+
+	// We need to hook GetFileSize too because the buffer is preallocated through malloc before the Read call happens.
+	// The vtable is shared by every stream, the slot is replaced once and stays that way: the hook returns the original size of unregistered streams,
+	// while putting the original back once a stream got served would unhook the streams still being read on other threads.
+	// Only the first of the concurrent loader threads to get here patches it.
+	static void hook_file_stream_get_file_size(void* file_stream)
+	{
+		static std::once_flag is_hooked;
+		std::call_once(is_hooked,
+		               [file_stream]()
+		               {
+			               void** FileStream_vtable = *(void***)file_stream;
+			               FileStream_vtable[6]     = hook_FileStreamGetFileSize;
+		               });
+	}
+
+	static big::patched_file_cache& get_sjson_patch_cache()
+	{
+		static big::patched_file_cache cache(std::filesystem::path(big::paths::get_project_root_folder()) / "cache" / "sjson_patches");
+		return cache;
+	}
+
+	// Bumped on every reload_game_data call and whenever a mod module gets loaded or cleaned up,
+	// what was checked during a load is checked again during the next one.
+	// Atomic rather than behind the module lock, module loads may already hold it.
+	static std::atomic<uint64_t> g_load_generation{0};
+
+	struct source_file
+	{
+		std::filesystem::path m_path;
+		uintmax_t m_size = 0;
+		std::filesystem::file_time_type m_write_time;
+
+		bool operator==(const source_file&) const = default;
+	};
+
+	// Scripts and config files of a mod, which its sjson patches are assumed to depend on.
+	struct mod_sources
+	{
+		std::vector<source_file> m_files;
+		uint64_t m_hash       = 0;
+		uint64_t m_generation = 0;
+	};
+
+	// Keyed by mod guid, so that it survives the mod getting hot reloaded. Only touched with the lua manager module lock held.
+	static std::unordered_map<std::string, mod_sources> g_mod_sources;
+
+	// Last patched output of each game data file whose callbacks are all cacheable, served again by incremental reloads
+	// without reading the file nor running the callbacks. Only kept once an incremental reload got requested,
+	// the outputs are shared with the file stream registry rather than copied. Only touched with the lua manager module lock held.
+	struct patched_output
+	{
+		// Which mods patch the file, how, and the hash of their sources: everything the output depends on but the file content,
+		// which is vouched for by the file size and write time instead.
+		uint64_t m_patch_key    = 0;
+		uintmax_t m_source_size = 0;
+		std::filesystem::file_time_type m_source_write_time;
+		std::shared_ptr<const std::string> m_data;
+	};
+
+	static std::unordered_map<std::string, patched_output> g_patched_outputs;
+	static bool g_is_keeping_patched_outputs = false;
+
+	// Since the last reload_game_data call: files served from g_patched_outputs, files patched again,
+	// and mods whose scripts or config files changed.
+	static size_t g_reused_file_count  = 0;
+	static size_t g_patched_file_count = 0;
+	static std::vector<std::string> g_changed_mod_guids;
+
+	// Per game data file, from the last time its table callbacks ran. Only touched with the lua manager module lock held.
+	static std::unordered_map<std::string, std::vector<big::sjson::conflict>> g_sjson_merge_conflicts;
+
+	static std::vector<source_file> list_mod_source_files(big::lua_module_ext* mod)
+	{
+		std::vector<source_file> res;
+		const auto add = [&res](const std::filesystem::directory_entry& entry)
+		{
+			std::error_code ec;
+			auto& file        = res.emplace_back();
+			file.m_path       = entry.path();
+			file.m_size       = entry.file_size(ec);
+			file.m_write_time = entry.last_write_time(ec);
+		};
+
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(mod->m_info.m_path.parent_path(), std::filesystem::directory_options::skip_permission_denied, ec))
 		{
-			// We need to hook GetFileSize too because the buffer is preallocated through malloc before the Read call happens.
-			// This is dirty as hell but we'll just double the size as I don't think
-			// it's possible to know in advance what our patches to the game files will do to the file size.
+			if (entry.path().extension() == ".lua")
 			{
-				void** FileStream_vtable = *(void***)file_stream;
-				if (original_GetFileSize == nullptr)
-				{
-					original_GetFileSize = FileStream_vtable[6];
-				}
-				FileStream_vtable[6] = hook_FileStreamGetFileSize;
+				add(entry);
 			}
 		}
-
-		current_file_stream = nullptr;
+		for (const auto& entry : std::filesystem::directory_iterator(big::g_file_manager.get_project_folder("config").get_path(), ec))
+		{
+			const std::string filename = (char*)entry.path().filename().u8string().c_str();
+			if (filename.starts_with(mod->guid()))
+			{
+				add(entry);
+			}
+		}
+		std::ranges::sort(res,
+		                  [](const source_file& left, const source_file& right)
+		                  {
+			                  return left.m_path < right.m_path;
+		                  });
 
 		return res;
 	}
 
-	static bool check_path(const std::filesystem::path& firstPath, const std::filesystem::path& secondPath)
+	// Hash of the scripts and config files of a mod. Their content is only read again when their size or write time changed,
+	// otherwise a load costs a directory listing per mod.
+	static uint64_t get_mod_hash(big::lua_module_ext* mod)
 	{
-		std::string full_file_path = (char*)firstPath.u8string().c_str();
-		std::string user_path      = (char*)secondPath.u8string().c_str();
+		auto& sources         = g_mod_sources[mod->guid()];
+		const auto generation = g_load_generation.load();
+		if (sources.m_generation == generation && sources.m_hash)
+		{
+			return sources.m_hash;
+		}
+
+		auto files           = list_mod_source_files(mod);
+		sources.m_generation = generation;
+		if (sources.m_hash && files == sources.m_files)
+		{
+			return sources.m_hash;
+		}
+
+		XXH64_state_t hasher;
+		XXH64_reset(&hasher, 0);
+		for (const auto& file : files)
+		{
+			// Hashed straight out of the mapping, an unreadable file hashes as empty, and one failing midway as what got read of it.
+			big::mapped_file content;
+			content.open(file.m_path);
+			const auto path = file.m_path.u8string();
+			XXH64_update(&hasher, path.data(), path.size());
+			big::mapped_file::guard_access(
+			    [&]()
+			    {
+				    XXH64_update(&hasher, content.data(), content.size());
+			    });
+		}
 
-		full_file_path = big::string::replace(full_file_path, "\\", "/");
-		user_path      = big::string::replace(user_path, "\\", "/");
+		if (sources.m_hash)
+		{
+			g_changed_mod_guids.push_back(mod->guid());
+		}
 
-		return full_file_path.contains(user_path);
+		sources.m_files = std::move(files);
+		// Zero means not computed yet.
+		sources.m_hash = XXH64_digest(&hasher) | 1;
+		return sources.m_hash;
 	}
 
-	static size_t hook_FileStreamRead(void* file_stream, void* outputBuffer, size_t bufferSizeInBytes)
+	// The game allocates its read buffer from GetFileSize before the Read call happens,
+	// so the mod callbacks are run right when the file is opened to know the exact patched size ahead of time.
+	// The whole file is read here once, the game Read is then served from the patched bytes.
+	static void patch_game_data_file(void* file_stream, const std::string& file_path)
 	{
-		std::unordered_map<void*, std::filesystem::path>::iterator it;
+		std::scoped_lock l(big::g_lua_manager->m_module_lock);
+
+		// Reused from one file to the next, the lookup then allocates nothing.
+		thread_local std::vector<big::sjson_callback_index::match> callbacks;
+		big::g_sjson_callback_index.find(file_path, callbacks);
 
-		bool is_game_data = false;
-		if (bufferSizeInBytes > 4)
+		// Looked up every time, a callback registering another one may move the vector of its mod around.
+		const auto get_info = [](const big::sjson_callback_index::match& callback)
 		{
-			std::scoped_lock l(g_FileStream_to_filename_mutex);
+			return &callback.m_mod->m_data_ext.m_on_sjson_game_data_read[callback.m_callback_index];
+		};
 
-			it = g_FileStream_to_filename.find(file_stream);
-			if (it != g_FileStream_to_filename.end() && it->second.extension() == ".sjson")
+		if (callbacks.empty())
+		{
+			big::hades::g_file_stream_registry.erase(file_stream);
+			return;
+		}
+
+		bool is_cacheable = true;
+		for (const auto& callback : callbacks)
+		{
+			is_cacheable &= callback.m_mod->m_data_ext.m_is_sjson_patch_cacheable;
+		}
+
+		uint64_t patch_key = 0;
+		std::error_code size_ec;
+		std::error_code time_ec;
+		// The path is UTF-8, a plain std::string would get decoded with the ANSI code page.
+		const std::filesystem::path source_path(std::u8string_view(reinterpret_cast<const char8_t*>(file_path.data()), file_path.size()));
+		const auto source_size       = std::filesystem::file_size(source_path, size_ec);
+		const auto source_write_time = std::filesystem::last_write_time(source_path, time_ec);
+		const bool is_source_known   = !size_ec && !time_ec;
+		if (is_cacheable)
+		{
+			XXH64_state_t hasher;
+			XXH64_reset(&hasher, 0);
+			const auto hash_string = [&hasher](std::string_view str)
+			{
+				const uint64_t size = str.size();
+				XXH64_update(&hasher, &size, sizeof(size));
+				XXH64_update(&hasher, str.data(), str.size());
+			};
+
+			hash_string(file_path);
+			for (const auto& callback : callbacks)
+			{
+				const auto mod_hash = get_mod_hash(callback.m_mod);
+				hash_string(callback.m_mod->guid());
+				hash_string(callback.m_mod->m_info.m_manifest.version_number);
+				XXH64_update(&hasher, &mod_hash, sizeof(mod_hash));
+				XXH64_update(&hasher, &get_info(callback)->m_read_kind, sizeof(big::lua_module_data_ext::sjson_read_kind));
+				hash_string(get_info(callback)->m_file_path);
+			}
+			patch_key = XXH64_digest(&hasher);
+
+			const auto it = g_patched_outputs.find(file_path);
+			if (it != g_patched_outputs.end() && it->second.m_patch_key == patch_key && is_source_known && it->second.m_source_size == source_size
+			    && it->second.m_source_write_time == source_write_time)
+			{
+				g_reused_file_count++;
+				big::hades::g_file_stream_registry.set_patched_data(file_stream, it->second.m_data);
+				hook_file_stream_get_file_size(file_stream);
+				return;
+			}
+		}
+
+		g_patched_file_count++;
+
+		// Remembered for the next incremental reload once the output is known.
+		const auto keep_output = [&](const std::shared_ptr<const std::string>& data)
+		{
+			if (!g_is_keeping_patched_outputs || !is_cacheable || !is_source_known)
+			{
+				g_patched_outputs.erase(file_path);
+				return;
+			}
+
+			auto& output               = g_patched_outputs[file_path];
+			output.m_patch_key         = patch_key;
+			output.m_source_size       = source_size;
+			output.m_source_write_time = source_write_time;
+			output.m_data              = data;
+		};
+
+		const auto file_size = *(size_t*)((uintptr_t)file_stream + 0x20);
+		std::string new_string(file_size, '\0');
+		new_string.resize(big::g_hooking->get_original<hook_FileStreamRead>()(file_stream, new_string.data(), file_size));
+
+		uint64_t cache_key = 0;
+		if (is_cacheable)
+		{
+			XXH64_state_t hasher;
+			XXH64_reset(&hasher, 0);
+			XXH64_update(&hasher, &patch_key, sizeof(patch_key));
+			XXH64_update(&hasher, new_string.data(), new_string.size());
+			cache_key = XXH64_digest(&hasher);
+
+			if (auto cached_string = get_sjson_patch_cache().get(cache_key))
 			{
-				// The actual size of the buffer in this case is half.
-				bufferSizeInBytes /= 2;
-				is_game_data       = true;
+				const auto data = std::make_shared<const std::string>(std::move(*cached_string));
+				keep_output(data);
+				big::hades::g_file_stream_registry.set_patched_data(file_stream, data);
+				hook_file_stream_get_file_size(file_stream);
+				return;
 			}
 		}
 
-		auto size_read = big::g_hooking->get_original<hook_FileStreamRead>()(file_stream, outputBuffer, bufferSizeInBytes);
+		// Consecutive table callbacks form a merge group: they share a single parse, each of them records its edits against it
+		// as a patch, and the patches are merged once the group ends. The text is only produced again when a string or buffer callback
+		// or the game needs it.
+		std::optional<big::sjson::document> document;
+		std::vector<big::sjson::patch> patches;
+		bool is_text_unparsable = false;
 
-		if (is_game_data)
+		const auto flush_document = [&]()
 		{
-			bool any_modif_happened = false;
-			std::string new_string;
-			bool assigned_new_string = false;
+			if (!document)
+			{
+				return;
+			}
 
-			std::scoped_lock l(big::g_lua_manager->m_module_lock);
-			for (const auto& mod_ : big::g_lua_manager->m_modules)
+			const bool is_modified = std::ranges::any_of(patches,
+			                                             [](const big::sjson::patch& patch)
+			                                             {
+				                                             return !patch.m_changes.empty();
+			                                             });
+
+			auto conflicts = big::sjson::merge(document->m_root, patches);
+			for (const auto& conflict : conflicts)
 			{
-				auto mod = (big::lua_module_ext*)mod_.get();
-				for (const auto& info : mod->m_data_ext.m_on_sjson_game_data_read)
+				std::string mods;
+				for (const auto& name : conflict.m_patch_names)
 				{
-					if (info.m_file_path.empty() || (info.m_file_path.size() && check_path(it->second, info.m_file_path)))
-					{
-						if (info.m_is_string_read)
-						{
-							if (!assigned_new_string)
-							{
-								new_string.assign((const char*)outputBuffer, bufferSizeInBytes);
-								assigned_new_string = true;
-							}
+					mods += mods.empty() ? name : ", " + name;
+				}
 
-							const auto res = info.m_callback((char*)it->second.u8string().c_str(), new_string.data());
-							if (res.valid() && res.get_type() == sol::type::string)
-							{
-								new_string = res.get<std::string>();
+				LOG(WARNING) << "sjson merge conflict in " << file_path << " on " << conflict.m_path << " between " << mods << ", "
+				             << conflict.m_patch_names.back() << " wins.";
+			}
+			g_sjson_merge_conflicts[file_path] = std::move(conflicts);
 
-								//LOG(INFO) << (char*)it->second.u8string().c_str() << " | " << new_string.size() << " | orig: " << bufferSizeInBytes << " | " << new_string;
+			if (is_modified)
+			{
+				new_string = big::sjson::serialize(*document, new_string.size());
+			}
 
-								if (bufferSizeInBytes * 2 < new_string.size())
-								{
-									std::stringstream ss;
-									ss << "Your patches won't work correctly because of my bad coding, please make an "
-									      "issue on the Hell2Modding repo, make sure to pass this info: Original file "
-									      "size "
-									   << bufferSizeInBytes << " | Doubled size: " << bufferSizeInBytes * 2
-									   << " | Needed size for patch: " << new_string.size()
-									   << " | filename: " << (char*)it->second.u8string().c_str();
-									MessageBoxA(0, ss.str().c_str(), "Hell2Modding", 0);
-								}
+			document.reset();
+			patches.clear();
+		};
 
-								any_modif_happened = true;
-							}
-						}
-					}
+		for (const auto& callback : callbacks)
+		{
+			switch (get_info(callback)->m_read_kind)
+			{
+			case big::lua_module_data_ext::sjson_read_kind::string:
+			{
+				flush_document();
+
+				const auto res = get_info(callback)->m_callback(file_path, std::string_view(new_string));
+				if (res.valid() && res.get_type() == sol::type::string)
+				{
+					// Straight out of the Lua string, without a temporary.
+					new_string.assign(res.get<std::string_view>());
+					is_text_unparsable = false;
 				}
+				break;
 			}
+			case big::lua_module_data_ext::sjson_read_kind::buffer:
+			{
+				flush_document();
+
+				// Edits land in new_string directly, which is what the game reads from in the end.
+				const auto buffer = std::make_shared<byte_buffer::byte_buffer>(new_string);
+				get_info(callback)->m_callback(file_path, buffer);
+				buffer->detach();
 
-			if (any_modif_happened)
+				if (buffer->is_modified())
+				{
+					is_text_unparsable = false;
+				}
+				break;
+			}
+			case big::lua_module_data_ext::sjson_read_kind::table:
 			{
-				memcpy(outputBuffer, new_string.data(), new_string.size());
-				size_read = new_string.size();
+				if (is_text_unparsable)
+				{
+					break;
+				}
+
+				if (!document)
+				{
+					std::string error;
+					document = big::sjson::parse(new_string, &error);
+					if (!document)
+					{
+						LOG(WARNING) << "Skipping the on_sjson_read_as_table callbacks of " << file_path << ", failed to parse it: " << error;
+						is_text_unparsable = true;
+						break;
+					}
+				}
+
+				auto& patch  = patches.emplace_back();
+				patch.m_name = callback.m_mod->guid();
+
+				// The recorder puts the document back as it was on destruction, the next callback doesn't see these edits.
+				big::sjson::patch_recorder recorder(document->m_root, patch);
+				const auto document_handle = std::make_shared<sjson_document::sjson_document>(recorder);
+				get_info(callback)->m_callback(file_path, document_handle);
+				document_handle->detach();
+				break;
+			}
 			}
+		}
+
+		flush_document();
+
+		if (is_cacheable)
+		{
+			get_sjson_patch_cache().set(cache_key, new_string);
+		}
+		const auto data = std::make_shared<const std::string>(std::move(new_string));
+		keep_output(data);
+
+		big::hades::g_file_stream_registry.set_patched_data(file_stream, data);
+		hook_file_stream_get_file_size(file_stream);
+	}
 
-			if (original_GetFileSize != nullptr)
+	static bool hook_FileStreamOpen(int64_t resourceDir, const char* fileName, int64_t mode, void* file_stream)
+	{
+		// The stream object may be reused from a previous file.
+		big::hades::g_file_stream_registry.erase(file_stream);
+
+		current_file_stream = file_stream;
+
+		const auto res = big::g_hooking->get_original<hook_FileStreamOpen>()(resourceDir, fileName, mode, file_stream);
+
+		current_file_stream = nullptr;
+
+		if (res)
+		{
+			thread_local std::string file_path;
+			if (big::hades::g_file_stream_registry.get_file_path(file_stream, file_path))
 			{
-				void** FileStream_vtable = *(void***)file_stream;
-				FileStream_vtable[6]     = original_GetFileSize;
+				patch_game_data_file(file_stream, file_path);
 			}
 		}
+		else
+		{
+			big::hades::g_file_stream_registry.erase(file_stream);
+		}
 
-		return size_read;
+		return res;
+	}
+
+	static void add_sjson_callback(sol::this_environment& env, std::string file_path_being_read, big::lua_module_data_ext::sjson_read_kind read_kind, sol::protected_function func)
+	{
+		auto mod = (big::lua_module_ext*)big::lua_module::this_from(env);
+		if (mod)
+		{
+			auto& callbacks = mod->m_data_ext.m_on_sjson_game_data_read;
+			callbacks.emplace_back(std::move(file_path_being_read), read_kind, std::move(func));
+			big::g_sjson_callback_index.add(mod, callbacks.size() - 1, callbacks.back().m_file_path);
+		}
 	}
 
 	// Lua API: Function
@@ -174,33 +504,172 @@ namespace lua::hades::data
 	// Param: function: function: Function called when game data file is read. The function must match signature: (string (file_path_being_read), string (file_content_buffer)) -> returns nothing (nil) or the new file buffer (string)
 	// Param: file_path_being_read: string: optional. Use only if you want your lua function to be called for a given file_path.
 	static void on_sjson_read_as_string_no_path_filter(sol::protected_function func, sol::this_environment env)
+	{
+		add_sjson_callback(env, "", big::lua_module_data_ext::sjson_read_kind::string, func);
+	}
+
+	static void on_sjson_read_as_string_with_path_filter(sol::protected_function func, const std::string& file_path_being_read, sol::this_environment env)
+	{
+		add_sjson_callback(env, file_path_being_read, big::lua_module_data_ext::sjson_read_kind::string, func);
+	}
+
+	// Lua API: Function
+	// Table: data
+	// Name: on_sjson_read_as_table
+	// Param: function: function: Function called when game data file is read. The function must match signature: (string (file_path_being_read), sjson_document (file_content)) -> returns nothing. Edit the file through the get, set, insert and remove methods of the document.
+	// Param: file_path_being_read: string: optional. Use only if you want your lua function to be called for a given file_path.
+	// The file is parsed once for all the mods using this function and turned back into text once after the last one, instead of every mod rewriting the whole file content as a string.
+	// **Example Usage:**
+	// ```lua
+	// rom.data.on_sjson_read_as_table(function(file_path, document)
+	//     document:set("Animations[Name=HecateBattleIdle].Scale", 1.5)
+	//     document:insert("Animations", { Name = "MyMod_NewAnimation", FilePath = "MyMod\\NewAnimation" })
+	//     document:remove("Animations[Name=Blank]")
+	// end, "Game/Animations/Fx.sjson")
+	// ```
+	static void on_sjson_read_as_table_no_path_filter(sol::protected_function func, sol::this_environment env)
+	{
+		add_sjson_callback(env, "", big::lua_module_data_ext::sjson_read_kind::table, func);
+	}
+
+	static void on_sjson_read_as_table_with_path_filter(sol::protected_function func, const std::string& file_path_being_read, sol::this_environment env)
+	{
+		add_sjson_callback(env, file_path_being_read, big::lua_module_data_ext::sjson_read_kind::table, func);
+	}
+
+	// Lua API: Function
+	// Table: data
+	// Name: on_sjson_read_as_buffer
+	// Param: function: function: Function called when game data file is read. The function must match signature: (string (file_path_being_read), byte_buffer (file_content)) -> returns nothing. Edit the file in place through the find, replace, insert and slice methods of the buffer.
+	// Param: file_path_being_read: string: optional. Use only if you want your lua function to be called for a given file_path.
+	// The mods using this function all edit the same bytes, the file content is never copied into a Lua string unless slice asks for it.
+	// **Example Usage:**
+	// ```lua
+	// rom.data.on_sjson_read_as_buffer(function(file_path, buffer)
+	//     buffer:replace("Scale = 1.0", "Scale = 1.5")
+	// end, "Game/Animations/Fx.sjson")
+	// ```
+	static void on_sjson_read_as_buffer_no_path_filter(sol::protected_function func, sol::this_environment env)
+	{
+		add_sjson_callback(env, "", big::lua_module_data_ext::sjson_read_kind::buffer, func);
+	}
+
+	static void on_sjson_read_as_buffer_with_path_filter(sol::protected_function func, const std::string& file_path_being_read, sol::this_environment env)
+	{
+		add_sjson_callback(env, file_path_being_read, big::lua_module_data_ext::sjson_read_kind::buffer, func);
+	}
+
+	// Lua API: Function
+	// Table: data
+	// Name: set_sjson_patches_cacheable
+	// Param: is_cacheable: boolean: Call with true if your on_sjson_read_as_string, on_sjson_read_as_table and on_sjson_read_as_buffer callbacks only depend on the file content and on your own mod files (scripts, config files). Their output is then saved to disk and later launches may serve it without calling them. Don't use it if your callbacks also read data out of the files for other purposes.
+	static void set_sjson_patches_cacheable(bool is_cacheable, sol::this_environment env)
 	{
 		auto mod = (big::lua_module_ext*)big::lua_module::this_from(env);
 		if (mod)
 		{
-			mod->m_data_ext.m_on_sjson_game_data_read.emplace_back("", true, func);
+			mod->m_data_ext.m_is_sjson_patch_cacheable = is_cacheable;
 		}
 	}
 
-	static void on_sjson_read_as_string_with_path_filter(sol::protected_function func, const std::string& file_path_being_read, sol::this_environment env)
+	// Lua API: Function
+	// Table: data
+	// Name: invalidate_sjson_cache
+	// Deletes every cached sjson patch output, the callbacks run again the next time the files are read.
+	static void invalidate_sjson_cache()
 	{
-		auto mod = (big::lua_module_ext*)big::lua_module::this_from(env);
-		if (mod)
+		get_sjson_patch_cache().invalidate();
+
+		std::scoped_lock l(big::g_lua_manager->m_module_lock);
+		g_mod_sources.clear();
+		g_patched_outputs.clear();
+	}
+
+	// Lua API: Function
+	// Table: data
+	// Name: get_sjson_cache_stats
+	// Returns: table: Table with the `hits`, `misses`, `writes` and `write_failures` integer counters of the sjson patch cache since the game started.
+	static sol::table get_sjson_cache_stats(sol::this_state state)
+	{
+		const auto stats = get_sjson_patch_cache().get_stats();
+
+		sol::table res(state, sol::create);
+		res["hits"]           = stats.m_hit_count;
+		res["misses"]         = stats.m_miss_count;
+		res["writes"]         = stats.m_write_count;
+		res["write_failures"] = stats.m_write_failed_count;
+		return res;
+	}
+
+	// Lua API: Function
+	// Table: data
+	// Name: get_sjson_merge_conflicts
+	// Returns: table: Array of the keys that several mods changed to different values from their on_sjson_read_as_table callbacks, as tables with the `file_path` string, the `key` path string and the `mods` array of mod guids, the last of which won. Files served from the sjson patch cache aren't merged again, their conflicts are only known from the launch that filled the cache.
+	static sol::table get_sjson_merge_conflicts(sol::this_state state)
+	{
+		sol::table res(state, sol::create);
+
+		std::scoped_lock l(big::g_lua_manager->m_module_lock);
+		for (const auto& [file_path, conflicts] : g_sjson_merge_conflicts)
 		{
-			mod->m_data_ext.m_on_sjson_game_data_read.emplace_back(file_path_being_read, true, func);
+			for (const auto& conflict : conflicts)
+			{
+				sol::table entry(state, sol::create);
+				entry["file_path"] = file_path;
+				entry["key"]       = conflict.m_path;
+				entry["mods"]      = sol::as_table(conflict.m_patch_names);
+				res.add(entry);
+			}
 		}
+
+		return res;
 	}
 
 	// Lua API: Function
 	// Table: data
 	// Name: reload_game_data
-	static void reload_game_data()
+	// Param: incremental: boolean: optional. When true, the game data files whose callbacks are all cacheable (see set_sjson_patches_cacheable) are served from their last patched output, unless the file itself, the scripts and config files of one of the mods patching it, or the set of callbacks patching it changed since. Only the affected files run their callbacks again. Patched outputs are only kept in memory from the first incremental reload on, which itself still reads every file and at best gets its output from the sjson patch cache. When false or omitted, every file is patched again and the mod files are hashed again from their content.
+	static void reload_game_data(sol::optional<bool> incremental)
 	{
-		static auto read_game_data_ptr = gmAddress::scan("7D 70 4C 8D 05", "ReadGameData");
-		if (read_game_data_ptr)
+		static auto read_game_data = big::hades2_symbols::ReadGameData.get();
+		if (read_game_data)
 		{
-			static auto f = read_game_data_ptr.offset(-0x7B).as_func<void()>();
-			f();
+			// Only the mod folders that changed get remounted.
+			big::plugins_data::refresh();
+
+			// Mod scripts or config files may have changed since.
+			{
+				std::scoped_lock l(big::g_lua_manager->m_module_lock);
+				g_load_generation++;
+				g_reused_file_count  = 0;
+				g_patched_file_count = 0;
+				g_changed_mod_guids.clear();
+				if (incremental.value_or(false))
+				{
+					g_is_keeping_patched_outputs = true;
+				}
+				else
+				{
+					g_mod_sources.clear();
+					g_patched_outputs.clear();
+				}
+			}
+
+			read_game_data();
+
+			if (incremental.value_or(false))
+			{
+				std::scoped_lock l(big::g_lua_manager->m_module_lock);
+
+				std::string changed_mods;
+				for (const auto& guid : g_changed_mod_guids)
+				{
+					changed_mods += changed_mods.empty() ? guid : ", " + guid;
+				}
+
+				LOG(INFO) << "Incremental game data reload: " << g_reused_file_count << " patched files served from the last load, "
+				          << g_patched_file_count << " patched again. Mods whose files changed: " << (changed_mods.empty() ? "none" : changed_mods);
+			}
 		}
 	}
 
@@ -211,38 +680,44 @@ namespace lua::hades::data
 	// Returns: string: Returns the string corresponding to the provided hash value.
 	static const char* get_string_from_hash_guid(unsigned int hash_guid)
 	{
-		static auto gStringBuffer =
-		    *gmAddress::scan("4C 03 0D ? ? ? ? 48 8B DA 0F B6 54 24", "gStringBuffer").offset(3).rip().as<const char**>();
+		static auto gStringBuffer = *big::hades2_symbols::gStringBuffer.get();
 
 		return &gStringBuffer[hash_guid];
 	}
 
+	void invalidate_mod_sources()
+	{
+		g_load_generation++;
+	}
+
 	void bind(sol::state_view& state, sol::table& lua_ext)
 	{
 		{
 			static auto hook_open = big::hooking::detour_hook_helper::add<hook_FileStreamOpen>(
 			    "hook_FileStreamOpen",
-			    gmAddress::scan("44 8B C9 33 D2", "FileStreamOpen").offset(-0x97));
+			    big::hades2_symbols::FileStreamOpen.address());
 		}
 		{
 			static auto hook_read = big::hooking::detour_hook_helper::add<hook_FileStreamRead>(
 			    "hook_FileStreamRead",
-			    gmAddress::scan("48 3B C3 74 42", "FileStreamRead").offset(-0x2D));
+			    big::hades2_symbols::FileStreamRead.address());
 		}
 
-		{
-			static auto fsAppendPathComponent_ptr = gmAddress::scan("C6 44 24 30 5C", "fsAppendPathComponent");
-			if (fsAppendPathComponent_ptr)
-			{
-				static auto fsAppendPathComponent = fsAppendPathComponent_ptr.offset(-0x97).as_func<void(const char*, const char*, char*)>();
-				static auto hook_fsAppendPathComponent_ = big::hooking::detour_hook_helper::add<hook_fsAppendPathComponent>("hook_fsAppendPathComponent", fsAppendPathComponent);
-			}
-		}
+		// Last, so it sees the path once the other handlers are done rewriting it.
+		big::hades::fs_append_path_component::add_handler("sjson file stream tracking", 1'000, track_file_stream_path);
 
 		auto ns = lua_ext.create_named("data");
 		ns.set_function("on_sjson_read_as_string", sol::overload(on_sjson_read_as_string_no_path_filter, on_sjson_read_as_string_with_path_filter));
+		ns.set_function("on_sjson_read_as_table", sol::overload(on_sjson_read_as_table_no_path_filter, on_sjson_read_as_table_with_path_filter));
+		ns.set_function("on_sjson_read_as_buffer", sol::overload(on_sjson_read_as_buffer_no_path_filter, on_sjson_read_as_buffer_with_path_filter));
+		ns.set_function("set_sjson_patches_cacheable", set_sjson_patches_cacheable);
+		ns.set_function("invalidate_sjson_cache", invalidate_sjson_cache);
+		ns.set_function("get_sjson_cache_stats", get_sjson_cache_stats);
+		ns.set_function("get_sjson_merge_conflicts", get_sjson_merge_conflicts);
 		ns.set_function("reload_game_data", reload_game_data);
 		ns.set_function("get_string_from_hash_guid", get_string_from_hash_guid);
+		sjson_document::bind(ns);
+		byte_buffer::bind(ns);
 
 		state["sol.__h2m_LoadPackages__"] = state["LoadPackages"];
 		// Lua API: Function
@@ -324,18 +799,15 @@ namespace lua::hades::data
 						bool is_bad_pkg              = true;
 						auto pkg_manifest_file_path  = full_path;
 						pkg_manifest_file_path      += ".pkg_manifest";
-						std::ifstream file(pkg_manifest_file_path);
-						if (file.is_open())
+						big::mapped_file file;
+						if (file.open(pkg_manifest_file_path))
 						{
-							std::string line;
-							while (std::getline(file, line))
-							{
-								if (line.find(stem) != std::string::npos)
-								{
-									is_bad_pkg = false;
-									break;
-								}
-							}
+							// Searched in place, the guid never spans lines. A file failing to read is a bad package.
+							big::mapped_file::guard_access(
+							    [&]()
+							    {
+								    is_bad_pkg = file.view().find(stem) == std::string_view::npos;
+							    });
 							if (is_bad_pkg)
 							{
 								const auto error_msg = std::format(
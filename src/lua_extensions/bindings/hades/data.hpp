@@ -3,4 +3,7 @@
 namespace lua::hades::data
 {
 	void bind(sol::state_view &state, sol::table &lua_ext);
+
+	// A mod module got loaded or cleaned up, its scripts may have changed: the sources of every mod are listed again the next time a patch depends on them.
+	void invalidate_mod_sources();
 }
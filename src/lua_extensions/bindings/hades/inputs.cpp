@@ -4,6 +4,7 @@
 #include "lua_extensions/bindings/tolk/tolk.hpp"
 #include "string/string.hpp"
 
+#include <hades2/hades2_signatures.hpp>
 #include <hooks/hooking.hpp>
 #include <lua/lua_manager.hpp>
 #include <lua_extensions/lua_module_ext.hpp>
@@ -439,11 +440,7 @@ namespace lua::hades::inputs
 
 	void bind(sol::state_view &state, sol::table &lua_ext)
 	{
-		static auto RegisterDebugKey_ptr = gmAddress::scan("E8 ? ? ? ? 90 48 8B 45 DF", "RegisterDebugKey");
-		if (RegisterDebugKey_ptr)
-		{
-			RegisterDebugKey = RegisterDebugKey_ptr.get_call();
-		}
+		RegisterDebugKey = big::hades2_symbols::RegisterDebugKey.address();
 
 		state["OnKeyPressed"] = [](sol::table args)
 		{
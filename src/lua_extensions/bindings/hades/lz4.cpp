@@ -1,63 +1,240 @@
-#include "audio.hpp"
+#include "lz4.hpp"
 
-#include <hooks/hooking.hpp>
-#include <memory/gm_address.hpp>
-#include <string/string.hpp>
+#include "byte_buffer.hpp"
+
+#include <lz4/folder_codec.hpp>
+#include <threads/thread_pool.hpp>
 
 namespace lua::hades::lz4
 {
-	// Lua API: Function
-	// Table: lz4
-	// Name: decompress_folder
-	// Param: folder_path_with_lz4_compressed_files: string: Path to folder containing lz4 compressed files.
-	// Param: output_folder_path: string: Path to the folder where decompressed files will be placed.
-	static void decompress_folder(const std::string &folder_path_with_lz4_compressed_files, const std::string &output_folder_path)
+	static std::string to_utf8(const std::filesystem::path &path)
 	{
-		static auto lz4_decompress_safe = gmAddress::scan("E9 B0 05 00 00", "lz4_decompress_safe").offset(-0x77).as_func<__int64(const char *, char *, int, int)>();
+		return (char *)path.u8string().c_str();
+	}
+
+	static std::filesystem::path from_utf8(std::string_view utf8)
+	{
+		return std::u8string_view(reinterpret_cast<const char8_t *>(utf8.data()), utf8.size());
+	}
+
+	static big::lz4::format get_format(const sol::optional<sol::table> &options)
+	{
+		return options && options->get_or<std::string>("format", "frame") == "block" ? big::lz4::format::block : big::lz4::format::frame;
+	}
+
+	static int get_level(const sol::optional<sol::table> &options)
+	{
+		return options ? options->get_or("level", 0) : 0;
+	}
+
+	static big::lz4::folder_options get_folder_options(const sol::optional<sol::table> &options, std::function<void(const big::lz4::folder_progress &)> &on_progress, const char *function_name)
+	{
+		big::lz4::folder_options folder_options;
+		if (!options)
+		{
+			return folder_options;
+		}
+
+		folder_options.m_max_memory       = options->get_or<size_t>("max_memory", folder_options.m_max_memory);
+		folder_options.m_max_worker_count = options->get_or<size_t>("max_worker_count", folder_options.m_max_worker_count);
+		folder_options.m_is_incremental   = options->get_or("incremental", folder_options.m_is_incremental);
 
-		for (const auto &entry : std::filesystem::recursive_directory_iterator(folder_path_with_lz4_compressed_files, std::filesystem::directory_options::skip_permission_denied | std::filesystem::directory_options::follow_directory_symlink))
+		sol::optional<sol::protected_function> on_progress_function = (*options)["on_progress"];
+		if (on_progress_function)
 		{
-			if (!entry.exists())
+			on_progress = [on_progress_function, function_name](const big::lz4::folder_progress &progress)
 			{
-				continue;
-			}
-			std::ifstream compressed_file(entry.path(), std::ios::binary);
-			compressed_file.seekg(0, std::ios::end);
-			std::streampos fileSize = compressed_file.tellg();
-			compressed_file.seekg(0, std::ios::beg);
-			std::vector<uint8_t> compressed_buffer(fileSize);
-			compressed_file.read((char *)compressed_buffer.data(), fileSize);
-			compressed_file.close();
-
-			std::vector<uint8_t> decompressed_buffer(20'971'520);
-			const auto decompressed_size = lz4_decompress_safe((char *)compressed_buffer.data(),
-			                                                   (char *)decompressed_buffer.data(),
-			                                                   compressed_buffer.size(),
-			                                                   20'971'520);
-
-			std::filesystem::path dump_file_path  = output_folder_path;
-			dump_file_path                       /= entry.path().stem();
-			std::ofstream file(dump_file_path, std::ios::out | std::ios::binary);
-
-			if (!file.is_open())
+				const auto res = (*on_progress_function)(progress.m_done_file_count, progress.m_file_count, progress.m_done_input_size, progress.m_input_size);
+				if (!res.valid())
+				{
+					const sol::error err = res;
+					LOG(ERROR) << function_name << " on_progress: " << err.what();
+				}
+			};
+		}
+
+		return folder_options;
+	}
+
+	static void spawn_worker(std::function<void()> work)
+	{
+		big::g_thread_pool->push(
+		    [work = std::move(work)]
+		    {
+			    work();
+		    });
+	}
+
+	static std::tuple<sol::table, sol::table> to_lua(const std::vector<big::lz4::file_result> &results, const big::lz4::folder_options &options, const char *function_name, sol::this_state state)
+	{
+		size_t skipped_file_count   = 0;
+		size_t processed_file_count = 0;
+		uint64_t skipped_size       = 0;
+		uint64_t processed_size     = 0;
+
+		sol::table res(state, sol::create);
+		for (const auto &result : results)
+		{
+			sol::table entry(state, sol::create);
+			entry["input_path"]  = to_utf8(result.m_input_path);
+			entry["output_path"] = to_utf8(result.m_output_path);
+			entry["input_size"]  = result.m_input_size;
+			entry["output_size"] = result.m_output_size;
+			entry["skipped"]     = result.m_is_skipped;
+			if (result.m_error.size())
 			{
-				LOG(ERROR) << "Failed to open file " << (char *)dump_file_path.u8string().c_str();
+				LOG(ERROR) << function_name << " failed on " << entry.get<std::string>("input_path") << ": " << result.m_error;
+				entry["error"] = result.m_error;
 			}
+			res.add(entry);
 
-			file.write((char *)decompressed_buffer.data(), decompressed_size);
-
-			if (!file)
+			if (result.m_is_skipped)
 			{
-				LOG(ERROR) << "Failed to write to file";
+				skipped_file_count++;
+				skipped_size += result.m_input_size;
 			}
+			else
+			{
+				processed_file_count++;
+				processed_size += result.m_input_size;
+			}
+		}
 
-			file.close();
+		if (options.m_is_incremental)
+		{
+			LOG(INFO) << function_name << ": " << skipped_file_count << " files (" << skipped_size << " bytes) still up to date, " << processed_file_count
+			          << " files (" << processed_size << " bytes) processed";
 		}
+
+		sol::table summary(state, sol::create);
+		summary["skipped_file_count"]   = skipped_file_count;
+		summary["skipped_bytes"]        = skipped_size;
+		summary["processed_file_count"] = processed_file_count;
+		summary["processed_bytes"]      = processed_size;
+		return {res, summary};
+	}
+
+	static std::optional<std::string_view> get_bytes(const sol::object &data)
+	{
+		if (data.get_type() == sol::type::string)
+		{
+			return data.as<std::string_view>();
+		}
+
+		if (data.is<byte_buffer::byte_buffer>())
+		{
+			return data.as<byte_buffer::byte_buffer &>().get_data();
+		}
+
+		return {};
+	}
+
+	// Lua API: Function
+	// Table: lz4
+	// Name: compress
+	// Param: data: string or byte_buffer: Bytes to compress.
+	// Param: options: table: optional. `format` string: "frame" (the default), self-describing with the content size and a checksum, or "block", the raw format of the game files. `level` integer: 0 by default, from 3 to 12 for the slower high compression mode, negative for faster and bigger outputs.
+	// Returns: string: The compressed bytes, or nil if the data is too big for the block format (2 GB).
+	// Uses the lz4 library bundled with the mod loader, it doesn't depend on the game.
+	// **Example Usage:**
+	// ```lua
+	// local compressed = rom.lz4.compress(save_data, { level = 9 })
+	// local save_data_again = rom.lz4.decompress(compressed)
+	// ```
+	static sol::object compress(const sol::object &data, sol::optional<sol::table> options, sol::this_state state)
+	{
+		const auto bytes = get_bytes(data);
+		if (!bytes)
+		{
+			LOG(ERROR) << "rom.lz4.compress: data must be a string or a byte_buffer";
+			return sol::lua_nil;
+		}
+
+		auto res = big::lz4::compress(*bytes, get_format(options), get_level(options));
+		return res ? sol::make_object(state, std::move(*res)) : sol::lua_nil;
+	}
+
+	// Lua API: Function
+	// Table: lz4
+	// Name: decompress
+	// Param: data: string or byte_buffer: lz4 frames, legacy lz4 frames, or a single raw lz4 block as the game files are.
+	// Returns: string: The decompressed bytes, or nil followed by an error message when the data isn't valid.
+	static std::tuple<sol::object, sol::object> decompress(const sol::object &data, sol::this_state state)
+	{
+		const auto bytes = get_bytes(data);
+		if (!bytes)
+		{
+			return {sol::lua_nil, sol::make_object(state, "data must be a string or a byte_buffer")};
+		}
+
+		std::string error;
+		auto res = big::lz4::decompress(*bytes, error);
+		if (!res)
+		{
+			return {sol::lua_nil, sol::make_object(state, error)};
+		}
+
+		return {sol::make_object(state, std::move(*res)), sol::lua_nil};
+	}
+
+	// Lua API: Function
+	// Table: lz4
+	// Name: decompress_folder
+	// Param: folder_path_with_lz4_compressed_files: string: Path to folder containing lz4 compressed files.
+	// Param: output_folder_path: string: Path to the folder where decompressed files will be placed.
+	// Param: options: table: optional. `max_memory` integer: upper bound in bytes for the buffers of all the worker threads together, 256 MB by default. `max_worker_count` integer: 0 (the default) for one worker per hardware thread. `on_progress` function: called with (done_file_count, file_count, done_input_bytes, input_bytes) as files get done. `incremental` boolean: false by default, skips the files left unchanged since the last incremental run whose output is still there, see below.
+	// Returns: table, table: One table per file, in listing order, with the `input_path` and `output_path` strings, the `input_size` and `output_size` integers, the `skipped` boolean, and an `error` string when the file failed. Then a summary with the `skipped_file_count`, `skipped_bytes`, `processed_file_count` and `processed_bytes` integers, bytes being input sizes.
+	// The files are decompressed in parallel on the thread pool, the call returns once all of them are done.
+	// Each file may hold lz4 frames, legacy lz4 frames, or a single raw lz4 block as the game writes them, of any size: files are mapped, and decompressed in place when their size is known upfront (raw blocks and frames storing their content size), a chunk at a time otherwise.
+	// Subfolders are flattened into the output folder: files sharing a name in different subfolders would overwrite each other's output, so none of them get processed and each gets an `error` instead.
+	// Incremental runs keep an index of the size, write time and content hash of every input next to the output folder, in `<output_folder_path>.lz4_index`.
+	// A file is skipped when its size is unchanged, its write time or else its content hash is too, and its output still has the size it was written with.
+	// **Example Usage:**
+	// ```lua
+	// local results, summary = rom.lz4.decompress_folder(input_folder, output_folder, {
+	//     incremental = true,
+	//     on_progress = function(done_file_count, file_count)
+	//         print(done_file_count .. "/" .. file_count)
+	//     end
+	// })
+	// print(summary.skipped_file_count .. " files up to date, " .. summary.processed_file_count .. " decompressed")
+	// for _, result in ipairs(results) do
+	//     if result.error then
+	//         print(result.input_path .. ": " .. result.error)
+	//     end
+	// end
+	// ```
+	static std::tuple<sol::table, sol::table> decompress_folder(const std::string &folder_path_with_lz4_compressed_files, const std::string &output_folder_path, sol::optional<sol::table> options, sol::this_state state)
+	{
+		std::function<void(const big::lz4::folder_progress &)> on_progress;
+		const auto folder_options = get_folder_options(options, on_progress, "rom.lz4.decompress_folder");
+
+		const auto results = big::lz4::decompress_folder(from_utf8(folder_path_with_lz4_compressed_files), from_utf8(output_folder_path), folder_options, spawn_worker, on_progress);
+		return to_lua(results, folder_options, "rom.lz4.decompress_folder", state);
+	}
+
+	// Lua API: Function
+	// Table: lz4
+	// Name: compress_folder
+	// Param: folder_path: string: Path to folder containing the files to compress.
+	// Param: output_folder_path: string: Path to the folder where the compressed files will be placed, named after the original files with `.lz4` appended.
+	// Param: options: table: optional. `format` and `level` as for compress, plus the `max_memory`, `max_worker_count`, `on_progress` and `incremental` options of decompress_folder. Changing the format or the level makes an incremental run process every file again.
+	// Returns: table, table: Same as decompress_folder.
+	static std::tuple<sol::table, sol::table> compress_folder(const std::string &folder_path, const std::string &output_folder_path, sol::optional<sol::table> options, sol::this_state state)
+	{
+		std::function<void(const big::lz4::folder_progress &)> on_progress;
+		const auto folder_options = get_folder_options(options, on_progress, "rom.lz4.compress_folder");
+
+		const auto results = big::lz4::compress_folder(from_utf8(folder_path), from_utf8(output_folder_path), get_format(options), get_level(options), folder_options, spawn_worker, on_progress);
+		return to_lua(results, folder_options, "rom.lz4.compress_folder", state);
 	}
 
 	void bind(sol::table &state)
 	{
 		auto ns = state.create_named("lz4");
+		ns.set_function("compress", compress);
+		ns.set_function("decompress", decompress);
 		ns.set_function("decompress_folder", decompress_folder);
+		ns.set_function("compress_folder", compress_folder);
 	}
 } // namespace lua::hades::lz4
@@ -0,0 +1,201 @@
+#include "sjson_document.hpp"
+
+#include <charconv>
+#include <cmath>
+
+namespace lua::hades::sjson_document
+{
+	// Lua tables referencing themselves would never end otherwise.
+	static constexpr size_t max_table_depth = 256;
+
+	static sol::object to_lua(const big::sjson::value& value, sol::state_view state)
+	{
+		switch (value.m_type)
+		{
+		case big::sjson::value_type::boolean: return sol::make_object(state, value.m_boolean);
+		case big::sjson::value_type::literal:
+		{
+			const auto begin = value.m_text.data();
+			const auto end   = begin + value.m_text.size();
+
+			int64_t integer = 0;
+			if (std::from_chars(begin, end, integer).ptr == end)
+			{
+				return sol::make_object(state, integer);
+			}
+
+			double number = 0;
+			if (std::from_chars(begin, end, number).ptr == end)
+			{
+				return sol::make_object(state, number);
+			}
+
+			return sol::make_object(state, value.m_text);
+		}
+		case big::sjson::value_type::string: return sol::make_object(state, value.get_decoded_text());
+		case big::sjson::value_type::array:
+		{
+			sol::table res(state, sol::create);
+			for (size_t i = 0; i < value.m_items.size(); i++)
+			{
+				res[i + 1] = to_lua(value.m_items[i], state);
+			}
+			return res;
+		}
+		case big::sjson::value_type::object:
+		{
+			sol::table res(state, sol::create);
+			for (size_t i = 0; i < value.m_keys.size(); i++)
+			{
+				res[value.m_keys[i]] = to_lua(value.m_items[i], state);
+			}
+			return res;
+		}
+		default: return sol::lua_nil;
+		}
+	}
+
+	static std::optional<big::sjson::value> from_lua(const sol::object& object, size_t depth)
+	{
+		big::sjson::value res;
+
+		switch (object.get_type())
+		{
+		case sol::type::lua_nil: return res;
+		case sol::type::boolean:
+		{
+			res.m_type    = big::sjson::value_type::boolean;
+			res.m_boolean = object.as<bool>();
+			return res;
+		}
+		case sol::type::number:
+		{
+			// SJSON has no literal for NaN nor the infinities, the file would fail to parse.
+			const auto number = object.as<double>();
+			if (!std::isfinite(number))
+			{
+				return std::nullopt;
+			}
+
+			res.m_type = big::sjson::value_type::literal;
+			res.m_text = std::trunc(number) == number && std::abs(number) < 1e15 ? std::format("{}", static_cast<int64_t>(number)) : std::format("{}", number);
+			return res;
+		}
+		case sol::type::string: return big::sjson::value::make_string(object.as<std::string_view>());
+		case sol::type::table:
+		{
+			if (depth > max_table_depth)
+			{
+				return std::nullopt;
+			}
+
+			const auto table = object.as<sol::table>();
+
+			size_t entry_count = 0;
+			for ([[maybe_unused]] const auto& entry : table)
+			{
+				entry_count++;
+			}
+
+			const auto sequence_size = table.size();
+			if (entry_count && sequence_size == entry_count)
+			{
+				res.m_type = big::sjson::value_type::array;
+				for (size_t i = 1; i <= sequence_size; i++)
+				{
+					auto item = from_lua(table.get<sol::object>(i), depth + 1);
+					if (!item)
+					{
+						return std::nullopt;
+					}
+					res.m_items.push_back(std::move(*item));
+				}
+				return res;
+			}
+
+			// Lua tables have no order, sorting the keys keeps the output stable from one launch to the next.
+			std::vector<std::pair<std::string, sol::object>> members;
+			for (const auto& [key, value] : table)
+			{
+				if (key.get_type() != sol::type::string)
+				{
+					return std::nullopt;
+				}
+				members.emplace_back(key.as<std::string>(), value);
+			}
+			std::ranges::sort(members,
+			                  [](const auto& left, const auto& right)
+			                  {
+				                  return left.first < right.first;
+			                  });
+
+			res.m_type = big::sjson::value_type::object;
+			for (auto& [key, value] : members)
+			{
+				auto item = from_lua(value, depth + 1);
+				if (!item)
+				{
+					return std::nullopt;
+				}
+				res.m_keys.push_back(std::move(key));
+				res.m_items.push_back(std::move(*item));
+			}
+			return res;
+		}
+		default: return std::nullopt;
+		}
+	}
+
+	sjson_document::sjson_document(big::sjson::patch_recorder& recorder) :
+	    m_recorder(&recorder)
+	{
+	}
+
+	void sjson_document::detach()
+	{
+		m_recorder = nullptr;
+	}
+
+	sol::object sjson_document::get(const std::string& path, sol::this_state state) const
+	{
+		const auto value = m_recorder ? m_recorder->find(path) : nullptr;
+		return value ? to_lua(*value, state) : sol::lua_nil;
+	}
+
+	bool sjson_document::set(const std::string& path, sol::object value)
+	{
+		auto new_value = m_recorder ? from_lua(value, 0) : std::nullopt;
+		return new_value && m_recorder->set(path, std::move(*new_value));
+	}
+
+	bool sjson_document::insert(const std::string& path, sol::object value)
+	{
+		auto new_value = m_recorder ? from_lua(value, 0) : std::nullopt;
+		return new_value && m_recorder->insert(path, std::move(*new_value));
+	}
+
+	bool sjson_document::insert_at(const std::string& path, size_t index, sol::object value)
+	{
+		auto new_value = m_recorder ? from_lua(value, 0) : std::nullopt;
+		return new_value && m_recorder->insert(path, std::move(*new_value), index);
+	}
+
+	bool sjson_document::remove(const std::string& path)
+	{
+		return m_recorder && m_recorder->remove(path);
+	}
+
+	void bind(sol::table& state)
+	{
+		state.new_usertype<sjson_document>("sjson_document",
+		                                   sol::no_constructor,
+		                                   "get",
+		                                   &sjson_document::get,
+		                                   "set",
+		                                   &sjson_document::set,
+		                                   "insert",
+		                                   sol::overload(&sjson_document::insert, &sjson_document::insert_at),
+		                                   "remove",
+		                                   &sjson_document::remove);
+	}
+} // namespace lua::hades::sjson_document
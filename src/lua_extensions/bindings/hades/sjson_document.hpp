@@ -0,0 +1,59 @@
+#pragma once
+
+#include <sjson/merge.hpp>
+
+namespace lua::hades::sjson_document
+{
+	// Lua API: Class
+	// Name: sjson_document
+	// Game data file handed to the rom.data.on_sjson_read_as_table callbacks, already parsed.
+	// Each mod sees the file as it was before any table callback ran, plus its own edits. The edits of all the mods are then merged
+	// and the file is turned back into text once. Keys edited by several mods are logged as conflicts, the mod loaded last wins.
+	// Paths are dot separated keys, each optionally followed by array selectors: `Animations[3]` is the third item, `Animations[Name=Foo]` the first item whose Name is Foo.
+	// The document is only valid during the callback it was handed to.
+	class sjson_document
+	{
+	public:
+		explicit sjson_document(big::sjson::patch_recorder& recorder);
+
+		// The callbacks are over, whatever a mod that held onto the object does with it afterwards is ignored.
+		void detach();
+
+		// Lua API: Function
+		// Class: sjson_document
+		// Name: get
+		// Param: path: string: Path to the value.
+		// Returns: any: The value converted to Lua (objects and arrays become tables, numbers become numbers), or nil if the path leads nowhere.
+		sol::object get(const std::string& path, sol::this_state state) const;
+
+		// Lua API: Function
+		// Class: sjson_document
+		// Name: set
+		// Param: path: string: Path to the value. The last key, and the keys leading to it, are created if missing.
+		// Param: value: any: New value: nil, boolean, number, string or table. Tables whose keys are 1..n become arrays, the others objects.
+		// Returns: boolean: True if the value got set.
+		bool set(const std::string& path, sol::object value);
+
+		// Lua API: Function
+		// Class: sjson_document
+		// Name: insert
+		// Param: path: string: Path to an array.
+		// Param: index: integer: optional. Position of the new item, appended at the end of the array if omitted.
+		// Param: value: any: New item, same conversions as set.
+		// Returns: boolean: True if the item got inserted.
+		bool insert(const std::string& path, sol::object value);
+		bool insert_at(const std::string& path, size_t index, sol::object value);
+
+		// Lua API: Function
+		// Class: sjson_document
+		// Name: remove
+		// Param: path: string: Path to the object key or array item to remove.
+		// Returns: boolean: True if something got removed.
+		bool remove(const std::string& path);
+
+	private:
+		big::sjson::patch_recorder* m_recorder;
+	};
+
+	void bind(sol::table& state);
+} // namespace lua::hades::sjson_document
@@ -15,16 +15,21 @@ namespace lua::paths_ext
 		return root_folder;
 	}
 
+	std::filesystem::path get_content_folder()
+	{
+		auto folder  = get_game_executable_folder().parent_path();
+		folder      /= "Content";
+
+		return folder;
+	}
+
 	// Lua API: Function
 	// Table: paths
 	// Name: Content
 	// Returns: string: Returns the GameFolder/Content folder path
 	static std::string hades_Content()
 	{
-		auto folder  = get_game_executable_folder().parent_path();
-		folder      /= "Content";
-
-		return (char*)folder.u8string().c_str();
+		return (char*)get_content_folder().u8string().c_str();
 	}
 
 	// Lua API: Function
@@ -2,5 +2,8 @@
 
 namespace lua::paths_ext
 {
+	// GameFolder/Content
+	std::filesystem::path get_content_folder();
+
 	void bind(sol::table& state);
 }
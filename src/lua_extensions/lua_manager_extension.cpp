@@ -10,6 +10,7 @@
 #include "bindings/paths_ext.hpp"
 #include "bindings/tolk/tolk.hpp"
 #include "lua_module_ext.hpp"
+#include "profiling/startup_timeline.hpp"
 
 namespace big::lua_manager_extension
 {
@@ -18,6 +19,7 @@ namespace big::lua_manager_extension
 		std::scoped_lock l(g_manager_mutex);
 
 		lua::hades::inputs::vanilla_key_callbacks.clear();
+		g_sjson_callback_index.clear();
 
 		g_is_lua_state_valid = false;
 
@@ -107,14 +109,25 @@ namespace big::lua_manager_extension
 		                             });
 
 		// Let's keep that list sorted the same as the solution file explorer
+		// Some of them scan their signatures and create their hooks here, each gets its own startup timeline span.
+		std::optional<startup_timeline::scoped_span> span;
+		span.emplace("lua binding", "audio");
 		lua::hades::audio::bind(lua_ext);
+		span.emplace("lua binding", "data");
 		lua::hades::data::bind(state, lua_ext);
+		span.emplace("lua binding", "inputs");
 		lua::hades::inputs::bind(state, lua_ext);
+		span.emplace("lua binding", "lz4");
 		lua::hades::lz4::bind(lua_ext);
+		span.emplace("lua binding", "luasocket");
 		lua::luasocket::bind(lua_ext);
+		span.emplace("lua binding", "tolk");
 		lua::tolk::bind(lua_ext);
+		span.emplace("lua binding", "gui_ext");
 		lua::gui_ext::bind(lua_ext);
+		span.emplace("lua binding", "lpeg");
 		lua::lpeg::bind(lua_ext);
+		span.emplace("lua binding", "paths_ext");
 		lua::paths_ext::bind(lua_ext);
 	}
 } // namespace big::lua_manager_extension
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "bindings/hades/data.hpp"
 #include "bindings/hades/inputs.hpp"
 #include "lua/lua_module.hpp"
+#include "sjson_callback_index.hpp"
 
 namespace big
 {
@@ -12,14 +14,24 @@ namespace big
 
 		std::vector<sol::protected_function> m_on_button_hover;
 
+		// What the callback gets handed: a copy of the file content as a Lua string, its parsed document, or its bytes to edit in place.
+		enum class sjson_read_kind : uint8_t
+		{
+			string,
+			table,
+			buffer,
+		};
+
 		struct on_sjson_game_data_read_t
 		{
 			std::string m_file_path;
-			bool m_is_string_read{};
+			sjson_read_kind m_read_kind{};
 			sol::protected_function m_callback;
 		};
 
 		std::vector<on_sjson_game_data_read_t> m_on_sjson_game_data_read;
+		// The mod vouched that its sjson callbacks only depend on the file content and its own files, their output can be served from the cache.
+		bool m_is_sjson_patch_cacheable = false;
 
 		std::map<std::string, std::vector<lua::hades::inputs::keybind_callback>> m_keybinds;
 	};
@@ -32,18 +44,28 @@ namespace big
 		lua_module_ext(const module_info& module_info, sol::environment& env) :
 		    lua_module(module_info, env)
 		{
+			lua::hades::data::invalidate_mod_sources();
 		}
 
 		lua_module_ext(const module_info& module_info, sol::state_view& state) :
 		    lua_module(module_info, state)
 		{
+			lua::hades::data::invalidate_mod_sources();
+		}
+
+		~lua_module_ext()
+		{
+			g_sjson_callback_index.remove_module(this);
 		}
 
 		inline void cleanup() override
 		{
 			lua_module::cleanup();
 
+			g_sjson_callback_index.remove_module(this);
 			m_data_ext = {};
+
+			lua::hades::data::invalidate_mod_sources();
 		}
 	};
 } // namespace big
@@ -0,0 +1,111 @@
+#include "sjson_callback_index.hpp"
+
+namespace big
+{
+	static bool is_separator(char c)
+	{
+		return c == '/' || c == '\\';
+	}
+
+	static bool contains_path(std::string_view path, std::string_view filter)
+	{
+		return !std::ranges::search(path,
+		                            filter,
+		                            [](char left, char right)
+		                            {
+			                            return left == right || (is_separator(left) && is_separator(right));
+		                            })
+		            .empty();
+	}
+
+	void sjson_callback_index::add(lua_module_ext* mod, size_t callback_index, std::string_view file_path_filter)
+	{
+		std::scoped_lock l(m_mutex);
+
+		entry new_entry{
+		    .m_match            = {.m_mod = mod, .m_callback_index = callback_index, .m_sequence = m_next_sequence++},
+		    .m_file_path_filter = std::string(file_path_filter),
+		};
+		std::ranges::replace(new_entry.m_file_path_filter, '\\', '/');
+
+		if (new_entry.m_file_path_filter.empty())
+		{
+			m_unfiltered_entries.push_back(std::move(new_entry));
+			return;
+		}
+
+		// Only game data files are ever looked up, a filter with a folder in front of a .sjson file name
+		// can only be part of a path whose file name is that same name.
+		const auto file_name_start = new_entry.m_file_path_filter.rfind('/');
+		if (file_name_start != std::string::npos && new_entry.m_file_path_filter.ends_with(".sjson"))
+		{
+			auto file_name = new_entry.m_file_path_filter.substr(file_name_start + 1);
+			m_file_name_entries[std::move(file_name)].push_back(std::move(new_entry));
+			return;
+		}
+
+		m_substring_entries.push_back(std::move(new_entry));
+	}
+
+	void sjson_callback_index::remove_module(const lua_module_ext* mod)
+	{
+		std::scoped_lock l(m_mutex);
+
+		const auto is_from_mod = [mod](const entry& entry)
+		{
+			return entry.m_match.m_mod == mod;
+		};
+
+		std::erase_if(m_unfiltered_entries, is_from_mod);
+		std::erase_if(m_substring_entries, is_from_mod);
+		for (auto it = m_file_name_entries.begin(); it != m_file_name_entries.end();)
+		{
+			std::erase_if(it->second, is_from_mod);
+			it = it->second.empty() ? m_file_name_entries.erase(it) : std::next(it);
+		}
+	}
+
+	void sjson_callback_index::clear()
+	{
+		std::scoped_lock l(m_mutex);
+
+		m_unfiltered_entries.clear();
+		m_file_name_entries.clear();
+		m_substring_entries.clear();
+	}
+
+	void sjson_callback_index::find(std::string_view file_path, std::vector<match>& output) const
+	{
+		output.clear();
+
+		std::scoped_lock l(m_mutex);
+
+		for (const auto& entry : m_unfiltered_entries)
+		{
+			output.push_back(entry.m_match);
+		}
+
+		const auto file_name = file_path.substr(file_path.find_last_of("/\\") + 1);
+		const auto it        = m_file_name_entries.find(file_name);
+		if (it != m_file_name_entries.end())
+		{
+			for (const auto& entry : it->second)
+			{
+				if (contains_path(file_path, entry.m_file_path_filter))
+				{
+					output.push_back(entry.m_match);
+				}
+			}
+		}
+
+		for (const auto& entry : m_substring_entries)
+		{
+			if (contains_path(file_path, entry.m_file_path_filter))
+			{
+				output.push_back(entry.m_match);
+			}
+		}
+
+		std::ranges::sort(output, {}, &match::m_sequence);
+	}
+} // namespace big
@@ -0,0 +1,59 @@
+#pragma once
+
+namespace big
+{
+	class lua_module_ext;
+
+	// Which on_sjson_read_as_string / on_sjson_read_as_table callbacks apply to which game data file.
+	// Maintained as mods register their callbacks, so that opening a file costs a hash probe on its file name
+	// instead of converting and comparing paths for every callback of every mod.
+	class sjson_callback_index
+	{
+	public:
+		struct match
+		{
+			lua_module_ext* m_mod;
+			// Position inside the m_data_ext.m_on_sjson_game_data_read of the mod.
+			size_t m_callback_index;
+			uint64_t m_sequence;
+		};
+
+		// Call right after the callback got appended to the m_on_sjson_game_data_read of the mod.
+		void add(lua_module_ext* mod, size_t callback_index, std::string_view file_path_filter);
+
+		void remove_module(const lua_module_ext* mod);
+		void clear();
+
+		// Callbacks whose filter is part of the file path, in registration order. Path separators compare equal to each other.
+		// output is cleared first, a vector reused from one call to the next makes the lookup allocation free.
+		void find(std::string_view file_path, std::vector<match>& output) const;
+
+	private:
+		struct entry
+		{
+			match m_match;
+			// '/' separated.
+			std::string m_file_path_filter;
+		};
+
+		struct string_hash
+		{
+			using is_transparent = void;
+
+			size_t operator()(std::string_view str) const
+			{
+				return std::hash<std::string_view>{}(str);
+			}
+		};
+
+		mutable std::mutex m_mutex;
+		uint64_t m_next_sequence = 0;
+		std::vector<entry> m_unfiltered_entries;
+		// Filters naming a file, keyed by that file name.
+		std::unordered_map<std::string, std::vector<entry>, string_hash, std::equal_to<>> m_file_name_entries;
+		// Filters only naming a folder or part of a name, still compared against the whole path.
+		std::vector<entry> m_substring_entries;
+	};
+
+	inline sjson_callback_index g_sjson_callback_index;
+} // namespace big
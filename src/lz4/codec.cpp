@@ -0,0 +1,547 @@
+#include "codec.hpp"
+
+#include <files/mapped_file.hpp>
+#include <lz4.h>
+#include <lz4frame.h>
+#include <lz4hc.h>
+
+namespace big::lz4
+{
+	// Starting output size of the frames that don't store their content size, when decompressed in place.
+	static constexpr size_t min_output_size = 1 << 20;
+
+	// Outputs are either a std::string or a writable mapped_file, resized as the data comes then cut down to it.
+	static bool resize_output(std::string& output, uint64_t size, std::string&)
+	{
+		output.resize(size);
+		return true;
+	}
+
+	static bool resize_output(mapped_file& output, uint64_t size, std::string& error)
+	{
+		if (!output.resize(size))
+		{
+			error = "failed to resize the output file";
+			return false;
+		}
+
+		return true;
+	}
+
+	// Room for size bytes past pos, growing at least twofold so that remapping stays rare.
+	template<typename Output>
+	static bool reserve_output(Output& output, uint64_t pos, uint64_t size, std::string& error)
+	{
+		if (output.size() - pos >= size)
+		{
+			return true;
+		}
+
+		return resize_output(output, std::max<uint64_t>(pos + size, output.size() * 2), error);
+	}
+
+	static LZ4F_preferences_t get_frame_preferences(int level, uint64_t content_size)
+	{
+		LZ4F_preferences_t preferences{};
+		preferences.compressionLevel              = std::min(level, max_level);
+		preferences.frameInfo.contentSize         = content_size;
+		preferences.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+		return preferences;
+	}
+
+	static int compress_block(const char* source, char* destination, int source_size, int destination_capacity, int level)
+	{
+		if (level >= high_compression_min_level)
+		{
+			return LZ4_compress_HC(source, destination, source_size, destination_capacity, std::min(level, max_level));
+		}
+
+		return LZ4_compress_fast(source, destination, source_size, destination_capacity, level < 0 ? -level : 1);
+	}
+
+	template<typename Output>
+	static bool compress_to(std::string_view data, format format, int level, Output& output, std::string& error)
+	{
+		if (format == format::block)
+		{
+			if (data.size() > LZ4_MAX_INPUT_SIZE)
+			{
+				error = "too big for the block format";
+				return false;
+			}
+
+			if (!resize_output(output, LZ4_compressBound(static_cast<int>(data.size())), error))
+			{
+				return false;
+			}
+
+			const auto size = compress_block(data.data(), output.data(), static_cast<int>(data.size()), static_cast<int>(output.size()), level);
+			if (size <= 0)
+			{
+				error = "failed to compress";
+				return false;
+			}
+
+			return resize_output(output, size, error);
+		}
+
+		const auto preferences = get_frame_preferences(level, data.size());
+		if (!resize_output(output, LZ4F_compressFrameBound(data.size(), &preferences), error))
+		{
+			return false;
+		}
+
+		const auto size = LZ4F_compressFrame(output.data(), output.size(), data.data(), data.size(), &preferences);
+		if (LZ4F_isError(size))
+		{
+			error = LZ4F_getErrorName(size);
+			return false;
+		}
+
+		return resize_output(output, size, error);
+	}
+
+	std::optional<std::string> compress(std::string_view data, format format, int level)
+	{
+		std::string res;
+		std::string error;
+		return compress_to(data, format, level, res, error) ? std::optional(std::move(res)) : std::nullopt;
+	}
+
+	template<typename Output>
+	static bool decompress_frames(std::string_view data, Output& output, std::string& error)
+	{
+		LZ4F_dctx* context = nullptr;
+		if (LZ4F_isError(LZ4F_createDecompressionContext(&context, LZ4F_VERSION)))
+		{
+			error = "failed to create an lz4 frame decompression context";
+			return false;
+		}
+		const std::unique_ptr<LZ4F_dctx, decltype(&LZ4F_freeDecompressionContext)> context_owner(context, LZ4F_freeDecompressionContext);
+
+		// Sized from the header when it has the content size, grown as needed otherwise.
+		LZ4F_frameInfo_t frame_info{};
+		size_t header_size = data.size();
+		if (LZ4F_isError(LZ4F_getFrameInfo(context, &frame_info, data.data(), &header_size)))
+		{
+			error = "corrupted lz4 frame header";
+			return false;
+		}
+		data.remove_prefix(header_size);
+
+		// lz4 can't do better than 255 to 1, a bigger content size is a lie.
+		if (frame_info.contentSize > data.size() * 255 + min_output_size)
+		{
+			error = "corrupted lz4 frame header";
+			return false;
+		}
+
+		if (!resize_output(output, frame_info.contentSize ? frame_info.contentSize : std::max<uint64_t>(data.size() * 4, min_output_size), error))
+		{
+			return false;
+		}
+
+		uint64_t pos         = 0;
+		size_t expected_size = 1;
+		while (true)
+		{
+			if (!reserve_output(output, pos, 1, error))
+			{
+				return false;
+			}
+
+			auto input_size     = data.size();
+			auto output_size    = static_cast<size_t>(output.size() - pos);
+			const auto capacity = output_size;
+			expected_size       = LZ4F_decompress(context, output.data() + pos, &output_size, data.data(), &input_size, nullptr);
+			if (LZ4F_isError(expected_size))
+			{
+				error = LZ4F_getErrorName(expected_size);
+				return false;
+			}
+
+			data.remove_prefix(input_size);
+			pos += output_size;
+
+			// Nothing left to read, and either the frame is done or the context had room left over: it has nothing more to give.
+			if (data.empty() && (!expected_size || output_size < capacity))
+			{
+				break;
+			}
+		}
+
+		if (expected_size)
+		{
+			error = "truncated lz4 frame";
+			return false;
+		}
+
+		return resize_output(output, pos, error);
+	}
+
+	// Frames without a content size and legacy frames don't tell their output size upfront: rather than growing an output
+	// until it fits, they're decompressed a chunk at a time into a buffer that stays in cache and handed to append as they go.
+	using append_output_t = std::function<bool(std::string_view chunk)>;
+
+	static bool is_output_size_unknown(std::string_view data)
+	{
+		uint32_t magic = 0;
+		if (data.size() >= sizeof(magic))
+		{
+			memcpy(&magic, data.data(), sizeof(magic));
+		}
+
+		// Content size flag of the frame descriptor, right after the magic number.
+		constexpr uint8_t content_size_flag = 0x08;
+		return magic == legacy_frame_magic || (magic == frame_magic && data.size() > sizeof(magic) && !(static_cast<uint8_t>(data[sizeof(magic)]) & content_size_flag));
+	}
+
+	static bool append_chunk(const append_output_t& append, std::string_view chunk, std::string& error)
+	{
+		if (chunk.size() && !append(chunk))
+		{
+			error = "failed to write the output";
+			return false;
+		}
+
+		return true;
+	}
+
+	static bool decompress_frames_streamed(std::string_view data, const append_output_t& append, std::string& error)
+	{
+		LZ4F_dctx* context = nullptr;
+		if (LZ4F_isError(LZ4F_createDecompressionContext(&context, LZ4F_VERSION)))
+		{
+			error = "failed to create an lz4 frame decompression context";
+			return false;
+		}
+		const std::unique_ptr<LZ4F_dctx, decltype(&LZ4F_freeDecompressionContext)> context_owner(context, LZ4F_freeDecompressionContext);
+
+		std::string chunk(stream_chunk_size, '\0');
+		size_t expected_size = 1;
+		while (true)
+		{
+			auto input_size  = data.size();
+			auto output_size = chunk.size();
+			expected_size    = LZ4F_decompress(context, chunk.data(), &output_size, data.data(), &input_size, nullptr);
+			if (LZ4F_isError(expected_size))
+			{
+				error = LZ4F_getErrorName(expected_size);
+				return false;
+			}
+
+			data.remove_prefix(input_size);
+			if (!append_chunk(append, std::string_view(chunk).substr(0, output_size), error))
+			{
+				return false;
+			}
+
+			// Nothing left to read, and either the frame is done or the context had room left over: it has nothing more to give.
+			if (data.empty() && (!expected_size || output_size < chunk.size()))
+			{
+				break;
+			}
+		}
+
+		if (expected_size)
+		{
+			error = "truncated lz4 frame";
+			return false;
+		}
+
+		return true;
+	}
+
+	// Legacy frames are a sequence of raw blocks of up to 8 MB each once decompressed, each preceded by its compressed size.
+	static bool decompress_legacy_frames(std::string_view data, const append_output_t& append, std::string& error)
+	{
+		data.remove_prefix(sizeof(legacy_frame_magic));
+
+		std::string block;
+		while (data.size())
+		{
+			uint32_t block_size = 0;
+			if (data.size() < sizeof(block_size))
+			{
+				error = "truncated lz4 legacy frame";
+				return false;
+			}
+			memcpy(&block_size, data.data(), sizeof(block_size));
+			data.remove_prefix(sizeof(block_size));
+
+			// Frames may be concatenated.
+			if (block_size == legacy_frame_magic)
+			{
+				continue;
+			}
+
+			if (block_size > data.size() || block_size > static_cast<uint32_t>(LZ4_compressBound(legacy_block_size)))
+			{
+				error = "corrupted lz4 legacy frame";
+				return false;
+			}
+
+			block.resize(legacy_block_size);
+			const auto size = LZ4_decompress_safe(data.data(), block.data(), static_cast<int>(block_size), static_cast<int>(legacy_block_size));
+			if (size < 0)
+			{
+				error = "corrupted lz4 legacy frame";
+				return false;
+			}
+
+			if (!append_chunk(append, std::string_view(block).substr(0, size), error))
+			{
+				return false;
+			}
+			data.remove_prefix(block_size);
+		}
+
+		return true;
+	}
+
+	static bool decompress_streamed(std::string_view data, const append_output_t& append, std::string& error)
+	{
+		uint32_t magic = 0;
+		memcpy(&magic, data.data(), sizeof(magic));
+		return magic == legacy_frame_magic ? decompress_legacy_frames(data, append, error) : decompress_frames_streamed(data, append, error);
+	}
+
+	template<typename Output>
+	static bool decompress_block(std::string_view data, Output& output, std::string& error)
+	{
+		const auto content_size = get_block_content_size(data);
+		if (!content_size || *content_size > LZ4_MAX_INPUT_SIZE || data.size() > LZ4_MAX_INPUT_SIZE)
+		{
+			error = "not lz4 compressed or corrupted";
+			return false;
+		}
+
+		if (!resize_output(output, *content_size, error))
+		{
+			return false;
+		}
+
+		if (LZ4_decompress_safe(data.data(), output.data(), static_cast<int>(data.size()), static_cast<int>(*content_size)) != static_cast<int>(*content_size))
+		{
+			error = "not lz4 compressed or corrupted";
+			return false;
+		}
+
+		return true;
+	}
+
+	// Whatever is_output_size_unknown doesn't take.
+	template<typename Output>
+	static bool decompress_to(std::string_view data, Output& output, std::string& error)
+	{
+		uint32_t magic = 0;
+		if (data.size() >= sizeof(magic))
+		{
+			memcpy(&magic, data.data(), sizeof(magic));
+		}
+
+		if (magic == frame_magic)
+		{
+			return decompress_frames(data, output, error);
+		}
+
+		return decompress_block(data, output, error);
+	}
+
+	std::optional<std::string> decompress(std::string_view data, std::string& error)
+	{
+		std::string res;
+		if (is_output_size_unknown(data))
+		{
+			const auto append = [&res](std::string_view chunk)
+			{
+				res += chunk;
+				return true;
+			};
+			return decompress_streamed(data, append, error) ? std::optional(std::move(res)) : std::nullopt;
+		}
+
+		return decompress_to(data, res, error) ? std::optional(std::move(res)) : std::nullopt;
+	}
+
+	std::optional<uint64_t> get_block_content_size(std::string_view block)
+	{
+		uint64_t size = 0;
+		size_t pos    = 0;
+		const auto read_length_in_block = [&](size_t& length)
+		{
+			uint8_t byte = 255;
+			while (byte == 255)
+			{
+				if (pos == block.size())
+				{
+					return false;
+				}
+
+				byte    = static_cast<uint8_t>(block[pos++]);
+				length += byte;
+			}
+
+			return true;
+		};
+
+		while (pos < block.size())
+		{
+			const auto token      = static_cast<uint8_t>(block[pos++]);
+			size_t literal_length = token >> 4;
+			if ((literal_length == 15 && !read_length_in_block(literal_length)) || block.size() - pos < literal_length)
+			{
+				return std::nullopt;
+			}
+
+			pos  += literal_length;
+			size += literal_length;
+			if (pos == block.size())
+			{
+				break;
+			}
+
+			size_t match_length = token & 15;
+			if (block.size() - pos < 2)
+			{
+				return std::nullopt;
+			}
+			pos += 2;
+			if (match_length == 15 && !read_length_in_block(match_length))
+			{
+				return std::nullopt;
+			}
+
+			size += match_length + 4;
+		}
+
+		return size;
+	}
+
+	static constexpr auto mapped_access_error = "I/O error while accessing the mapped files";
+
+	// Has process fill output_path mapped from the mapped input, and deletes the output when that fails.
+	template<typename Process>
+	static std::string process_mapped_files(const mapped_file& input, const std::filesystem::path& output_path, uint64_t& output_size, const Process& process)
+	{
+		mapped_file output;
+		if (!output.create(output_path, 0))
+		{
+			return std::format("failed to open {}", (char*)output_path.u8string().c_str());
+		}
+
+		std::string error;
+		bool is_processed = false;
+		if (!mapped_file::guard_access(
+		        [&]()
+		        {
+			        is_processed = process(input.view(), output, error);
+		        }))
+		{
+			error = mapped_access_error;
+		}
+
+		if (is_processed)
+		{
+			output_size = output.size();
+			return error;
+		}
+
+		output.close();
+		std::error_code ec;
+		std::filesystem::remove(output_path, ec);
+		return error;
+	}
+
+	// Writes the output of decompress_streamed out as it comes, and deletes it when that fails.
+	static std::string decompress_streamed_file(const mapped_file& input, const std::filesystem::path& output_path, uint64_t& output_size)
+	{
+		std::ofstream output(output_path, std::ios::binary | std::ios::trunc);
+		if (!output)
+		{
+			return std::format("failed to open {}", (char*)output_path.u8string().c_str());
+		}
+
+		uint64_t size = 0;
+		const auto append = [&output, &size](std::string_view chunk)
+		{
+			size += chunk.size();
+			return static_cast<bool>(output.write(chunk.data(), chunk.size()));
+		};
+
+		std::string error;
+		bool is_processed = false;
+		if (!mapped_file::guard_access(
+		        [&]()
+		        {
+			        is_processed = decompress_streamed(input.view(), append, error);
+		        }))
+		{
+			error = mapped_access_error;
+		}
+
+		output.close();
+		if (is_processed && !output.fail())
+		{
+			output_size = size;
+			return error;
+		}
+
+		if (error.empty())
+		{
+			error = "failed to write the output";
+		}
+		std::error_code ec;
+		std::filesystem::remove(output_path, ec);
+		return error;
+	}
+
+	std::string decompress_file(const std::filesystem::path& input_path, const std::filesystem::path& output_path, uint64_t& output_size)
+	{
+		mapped_file input;
+		if (!input.open(input_path))
+		{
+			return "failed to open the file";
+		}
+
+		bool is_streamed = false;
+		if (!mapped_file::guard_access(
+		        [&]()
+		        {
+			        is_streamed = is_output_size_unknown(input.view());
+		        }))
+		{
+			return mapped_access_error;
+		}
+
+		if (is_streamed)
+		{
+			return decompress_streamed_file(input, output_path, output_size);
+		}
+
+		return process_mapped_files(input,
+		                            output_path,
+		                            output_size,
+		                            [](std::string_view input, mapped_file& output, std::string& error)
+		                            {
+			                            return decompress_to(input, output, error);
+		                            });
+	}
+
+	std::string compress_file(const std::filesystem::path& input_path, const std::filesystem::path& output_path, format format, int level, uint64_t& output_size)
+	{
+		mapped_file input;
+		if (!input.open(input_path))
+		{
+			return "failed to open the file";
+		}
+
+		return process_mapped_files(input,
+		                            output_path,
+		                            output_size,
+		                            [format, level](std::string_view input, mapped_file& output, std::string& error)
+		                            {
+			                            return compress_to(input, format, level, output, error);
+		                            });
+	}
+} // namespace big::lz4
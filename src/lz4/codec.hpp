@@ -0,0 +1,48 @@
+#pragma once
+
+namespace big::lz4
+{
+	inline constexpr uint32_t frame_magic        = 0x18'4D'22'04;
+	inline constexpr uint32_t legacy_frame_magic = 0x18'4C'21'02;
+	// Decompressed size of every legacy frame block but the last.
+	inline constexpr size_t legacy_block_size = 8 * 1'024 * 1'024;
+
+	// Output decompressed and written at a time for the frames that don't store their content size.
+	inline constexpr size_t stream_chunk_size = 1 << 20;
+
+	// Most heap memory a single decompress_file or compress_file call holds, both files being mapped:
+	// the buffers a frame context needs for the 4 MB blocks it can't decode in place, plus the chunk streamed outputs go through.
+	// Legacy frames only hold the buffer their 8 MB blocks get decoded into.
+	inline constexpr size_t max_file_memory = 2 * 4 * 1'024 * 1'024 + 128 * 1'024 + stream_chunk_size;
+
+	enum class format : uint8_t
+	{
+		// What the game files are: smallest, but nothing tells it apart from random bytes and its content size has to be found again by a pass over it.
+		block,
+		// Self-describing, with the content size and a checksum of the content, and streamable.
+		frame,
+	};
+
+	// Levels below 3 use the fast compressor, negative ones trading ratio for even more speed.
+	// From 3 to 12 the high compression one, slower to compress but as fast to decompress.
+	inline constexpr int high_compression_min_level = 3;
+	inline constexpr int max_level                  = 12;
+
+	std::optional<std::string> compress(std::string_view data, format format, int level);
+
+	// Frames and legacy frames are recognized from their magic number, anything else is taken as a raw block.
+	std::optional<std::string> decompress(std::string_view data, std::string& error);
+
+	// Raw blocks don't store their content size, a pass over their sequences gives it without decoding them.
+	std::optional<uint64_t> get_block_content_size(std::string_view block);
+
+	// Decompresses input_path into output_path, whatever its size. The input is mapped. Raw blocks and frames storing their content size
+	// are decompressed in place into the output mapped at its final size. Frames without it and legacy frames are decompressed a chunk at a time
+	// and written out as they go, which costs less than growing a mapped output until it fits.
+	// The input may hold lz4 frames (content size checked when the header has it), legacy frames, or a single raw lz4 block as the game writes them.
+	// Returns the error, empty on success, in which case output_size is set. A failed output gets deleted.
+	std::string decompress_file(const std::filesystem::path& input_path, const std::filesystem::path& output_path, uint64_t& output_size);
+
+	// Same contract as decompress_file, the output is mapped at the most the compressed data may take then cut down to it.
+	std::string compress_file(const std::filesystem::path& input_path, const std::filesystem::path& output_path, format format, int level, uint64_t& output_size);
+} // namespace big::lz4
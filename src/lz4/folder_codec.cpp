@@ -0,0 +1,232 @@
+#include "folder_codec.hpp"
+
+#include "folder_index.hpp"
+
+#include <numeric>
+#include <threads/parallel_jobs.hpp>
+#include <unordered_map>
+
+namespace big::lz4
+{
+	using file_processor = std::function<std::string(const std::filesystem::path& input_path, const std::filesystem::path& output_path, uint64_t& output_size)>;
+
+	// operation names what process_file does with its settings, an index written for another operation is thrown away.
+	static std::vector<file_result> process_folder(const std::filesystem::path& input_folder, const std::filesystem::path& output_folder, const std::function<std::filesystem::path(const std::filesystem::path&)>& get_output_filename, file_processor process_file, const std::string& operation, const folder_options& options, const spawn_worker_t& spawn_worker, const std::function<void(const folder_progress&)>& on_progress)
+	{
+		std::vector<file_result> results;
+		// Incremental runs only, indexed like results.
+		std::vector<std::string> index_keys;
+		std::vector<int64_t> input_write_times;
+
+		uint64_t input_size = 0;
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(input_folder, std::filesystem::directory_options::skip_permission_denied | std::filesystem::directory_options::follow_directory_symlink, ec))
+		{
+			if (!entry.is_regular_file(ec))
+			{
+				continue;
+			}
+
+			auto& result         = results.emplace_back();
+			result.m_input_path  = entry.path();
+			result.m_output_path = output_folder / get_output_filename(entry.path());
+			result.m_input_size  = entry.file_size(ec);
+			input_size          += result.m_input_size;
+
+			if (options.m_is_incremental)
+			{
+				index_keys.push_back((char*)entry.path().lexically_relative(input_folder).generic_u8string().c_str());
+				input_write_times.push_back(entry.last_write_time(ec).time_since_epoch().count());
+			}
+		}
+
+		const auto job_count = results.size();
+		if (!job_count)
+		{
+			return {};
+		}
+
+		// Subfolders are flattened, files sharing a name in different ones would all write the same output: none of them get processed.
+		// Case insensitive like the file system, for ASCII only.
+		std::unordered_map<std::string, std::vector<size_t>> output_path_users;
+		for (size_t i = 0; i < job_count; i++)
+		{
+			std::string key = (char*)results[i].m_output_path.filename().u8string().c_str();
+			std::ranges::transform(key,
+			                       key.begin(),
+			                       [](unsigned char c)
+			                       {
+				                       return static_cast<char>(std::tolower(c));
+			                       });
+			output_path_users[key].push_back(i);
+		}
+		for (const auto& [key, users] : output_path_users)
+		{
+			if (users.size() < 2)
+			{
+				continue;
+			}
+
+			for (const auto user : users)
+			{
+				const auto other      = users[user == users[0] ? 1 : 0];
+				results[user].m_error = std::format("Same output path as {}", (char*)results[other].m_input_path.u8string().c_str());
+			}
+		}
+
+		std::filesystem::create_directories(output_folder, ec);
+
+		const std::string input_folder_key = (char*)std::filesystem::absolute(input_folder).lexically_normal().u8string().c_str();
+		folder_index index(folder_index::get_file_path(output_folder));
+		folder_index::entry_map previous_entries;
+		std::vector<std::optional<folder_index::entry>> index_entries;
+		if (options.m_is_incremental)
+		{
+			index.load(input_folder_key, operation);
+			previous_entries = index.entries();
+			index_entries.resize(job_count);
+		}
+
+		// Indices into results, largest input first.
+		std::vector<size_t> job_order(job_count);
+		std::iota(job_order.begin(), job_order.end(), 0);
+		std::ranges::stable_sort(job_order,
+		                         [&results](size_t left, size_t right)
+		                         {
+			                         return results[left].m_input_size > results[right].m_input_size;
+		                         });
+
+		const auto process_job = [&](size_t job_index)
+		{
+			auto& result = results[job_index];
+			if (!options.m_is_incremental)
+			{
+				result.m_error = process_file(result.m_input_path, result.m_output_path, result.m_output_size);
+				return;
+			}
+
+			folder_index::entry current{.m_input_size = result.m_input_size, .m_input_write_time = input_write_times[job_index]};
+
+			std::error_code ec;
+			const auto previous_it = previous_entries.find(index_keys[job_index]);
+			if (previous_it != previous_entries.end() && previous_it->second.m_input_size == current.m_input_size
+			    && std::filesystem::file_size(result.m_output_path, ec) == previous_it->second.m_output_size && !ec)
+			{
+				// Only a file whose write time changed gets hashed, touching it doesn't make it get processed again.
+				const auto& previous = previous_it->second;
+				current.m_input_hash = previous.m_input_write_time == current.m_input_write_time ? previous.m_input_hash : hash_file(result.m_input_path);
+				if (current.m_input_hash == previous.m_input_hash)
+				{
+					current.m_output_size    = previous.m_output_size;
+					result.m_output_size     = previous.m_output_size;
+					result.m_is_skipped      = true;
+					index_entries[job_index] = current;
+					return;
+				}
+			}
+
+			result.m_error = process_file(result.m_input_path, result.m_output_path, result.m_output_size);
+			if (result.m_error.empty())
+			{
+				if (!current.m_input_hash)
+				{
+					current.m_input_hash = hash_file(result.m_input_path);
+				}
+				current.m_output_size    = result.m_output_size;
+				index_entries[job_index] = current;
+			}
+		};
+
+		// Files are mapped, the page cache holds their content rather than the workers.
+		const auto memory_worker_count = std::max<size_t>(options.m_max_memory / max_file_memory, 1);
+		const auto thread_count        = options.m_max_worker_count ? options.m_max_worker_count : std::thread::hardware_concurrency();
+
+		std::atomic<size_t> done_file_count{0};
+		std::atomic<uint64_t> done_input_size{0};
+		std::function<void()> report_progress;
+		if (on_progress)
+		{
+			report_progress = [&]()
+			{
+				on_progress({.m_done_file_count = done_file_count.load(), .m_file_count = job_count, .m_done_input_size = done_input_size.load(), .m_input_size = input_size});
+			};
+		}
+
+		run_parallel_jobs(job_count,
+		                  std::min(thread_count, memory_worker_count),
+		                  spawn_worker,
+		                  [&](size_t job)
+		                  {
+			                  const auto job_index = job_order[job];
+			                  if (results[job_index].m_error.empty())
+			                  {
+				                  process_job(job_index);
+			                  }
+
+			                  done_input_size += results[job_index].m_input_size;
+			                  done_file_count++;
+		                  },
+		                  report_progress);
+
+		// Failed files are left out, they get processed again next time.
+		if (options.m_is_incremental)
+		{
+			folder_index::entry_map entries;
+			for (size_t i = 0; i < job_count; i++)
+			{
+				if (index_entries[i])
+				{
+					entries.emplace(std::move(index_keys[i]), *index_entries[i]);
+				}
+			}
+
+			if (entries != index.entries())
+			{
+				index.set_entries(std::move(entries));
+				if (!index.write(input_folder_key, operation))
+				{
+					LOG(WARNING) << "Failed to write the lz4 folder index of " << (char*)output_folder.u8string().c_str();
+				}
+			}
+		}
+
+		return results;
+	}
+
+	std::vector<file_result> decompress_folder(const std::filesystem::path& input_folder, const std::filesystem::path& output_folder, const folder_options& options, const spawn_worker_t& spawn_worker, const std::function<void(const folder_progress&)>& on_progress)
+	{
+		return process_folder(
+		    input_folder,
+		    output_folder,
+		    [](const std::filesystem::path& input_path)
+		    {
+			    return input_path.stem();
+		    },
+		    decompress_file,
+		    "decompress",
+		    options,
+		    spawn_worker,
+		    on_progress);
+	}
+
+	std::vector<file_result> compress_folder(const std::filesystem::path& input_folder, const std::filesystem::path& output_folder, format format, int level, const folder_options& options, const spawn_worker_t& spawn_worker, const std::function<void(const folder_progress&)>& on_progress)
+	{
+		return process_folder(
+		    input_folder,
+		    output_folder,
+		    [](const std::filesystem::path& input_path)
+		    {
+			    auto res = input_path.filename();
+			    res     += ".lz4";
+			    return res;
+		    },
+		    [format, level](const std::filesystem::path& input_path, const std::filesystem::path& output_path, uint64_t& output_size)
+		    {
+			    return compress_file(input_path, output_path, format, level, output_size);
+		    },
+		    std::format("compress {} {}", format == format::block ? "block" : "frame", level),
+		    options,
+		    spawn_worker,
+		    on_progress);
+	}
+} // namespace big::lz4
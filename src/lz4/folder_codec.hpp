@@ -0,0 +1,48 @@
+#pragma once
+
+#include "codec.hpp"
+
+#include <threads/parallel_jobs.hpp>
+
+namespace big::lz4
+{
+	struct folder_options
+	{
+		// Upper bound for the lz4 context buffers of all the workers together, max_file_memory each, fewer workers run when it doesn't fit one per hardware thread.
+		size_t m_max_memory = 256 * 1'024 * 1'024;
+		// 0 for one worker per hardware thread.
+		size_t m_max_worker_count = 0;
+		// Skips the files whose output is still valid according to the folder_index of the last incremental run, then updates it.
+		bool m_is_incremental = false;
+	};
+
+	struct file_result
+	{
+		std::filesystem::path m_input_path;
+		std::filesystem::path m_output_path;
+		uint64_t m_input_size  = 0;
+		uint64_t m_output_size = 0;
+		// Empty on success.
+		std::string m_error;
+		// Incremental runs only: the output was still valid and got left as is.
+		bool m_is_skipped = false;
+	};
+
+	struct folder_progress
+	{
+		size_t m_done_file_count   = 0;
+		size_t m_file_count        = 0;
+		uint64_t m_done_input_size = 0;
+		uint64_t m_input_size      = 0;
+	};
+
+	// Decompresses every file under input_folder, recursively, into output_folder under the name of the file without its last extension.
+	// Files are jobs handed out largest first, spawn_worker hands a worker to another thread. Both the input and output files are mapped.
+	// The calling thread works too, so this returns even if no spawned worker ever gets to run.
+	// on_progress is only ever called from the calling thread, between its own jobs and while it waits for the other workers.
+	// Results are in listing order. Files whose output name is shared with a file of another subfolder all fail without being processed.
+	std::vector<file_result> decompress_folder(const std::filesystem::path& input_folder, const std::filesystem::path& output_folder, const folder_options& options, const spawn_worker_t& spawn_worker, const std::function<void(const folder_progress&)>& on_progress);
+
+	// Same as decompress_folder the other way around, outputs get named after the file with .lz4 appended.
+	std::vector<file_result> compress_folder(const std::filesystem::path& input_folder, const std::filesystem::path& output_folder, format format, int level, const folder_options& options, const spawn_worker_t& spawn_worker, const std::function<void(const folder_progress&)>& on_progress);
+} // namespace big::lz4
@@ -0,0 +1,208 @@
+#include "folder_index.hpp"
+
+#include <files/mapped_file.hpp>
+#include <xxhash.h>
+
+namespace big::lz4
+{
+	// Bump when the layout of the file changes.
+	static constexpr uint32_t index_format_version = 1;
+	static constexpr uint32_t index_magic          = 0x49'46'34'4C; // "L4FI"
+
+#pragma pack(push, 1)
+
+	struct index_header
+	{
+		uint32_t m_magic;
+		uint32_t m_format_version;
+		uint32_t m_entry_count;
+	};
+
+#pragma pack(pop)
+
+	// Bounds checked reads over the whole file, any failure makes the index get thrown away.
+	class index_reader
+	{
+	public:
+		explicit index_reader(std::string_view data) :
+		    m_data(data)
+		{
+		}
+
+		template<typename T>
+		bool read(T& value)
+		{
+			if (m_data.size() - m_cursor < sizeof(T))
+			{
+				return false;
+			}
+
+			memcpy(&value, m_data.data() + m_cursor, sizeof(T));
+			m_cursor += sizeof(T);
+			return true;
+		}
+
+		bool read_string(std::string& value)
+		{
+			uint32_t size = 0;
+			if (!read(size) || m_data.size() - m_cursor < size)
+			{
+				return false;
+			}
+
+			value.assign(m_data.data() + m_cursor, size);
+			m_cursor += size;
+			return true;
+		}
+
+	private:
+		std::string_view m_data;
+		size_t m_cursor = 0;
+	};
+
+	template<typename T>
+	static void write_value(std::ofstream& file, const T& value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	static void write_string(std::ofstream& file, std::string_view value)
+	{
+		write_value(file, static_cast<uint32_t>(value.size()));
+		file.write(value.data(), value.size());
+	}
+
+	folder_index::folder_index(std::filesystem::path file_path) :
+	    m_file_path(std::move(file_path))
+	{
+	}
+
+	std::filesystem::path folder_index::get_file_path(const std::filesystem::path& output_folder)
+	{
+		auto folder = std::filesystem::absolute(output_folder).lexically_normal();
+		if (!folder.has_filename())
+		{
+			folder = folder.parent_path();
+		}
+
+		auto res  = folder;
+		res      += ".lz4_index";
+		return res;
+	}
+
+	bool folder_index::load(std::string_view input_folder, std::string_view operation)
+	{
+		m_entries.clear();
+
+		mapped_file file;
+		if (!file.open(m_file_path))
+		{
+			return false;
+		}
+
+		// A file failing to read midway is no index either.
+		const auto read = [&]()
+		{
+			index_reader reader(file.view());
+
+			index_header header{};
+			std::string file_input_folder;
+			std::string file_operation;
+			if (!reader.read(header) || header.m_magic != index_magic || header.m_format_version != index_format_version || !reader.read_string(file_input_folder)
+			    || !reader.read_string(file_operation) || file_input_folder != input_folder || file_operation != operation)
+			{
+				return false;
+			}
+
+			for (uint32_t i = 0; i < header.m_entry_count; i++)
+			{
+				std::string key;
+				entry value;
+				if (!reader.read_string(key) || !reader.read(value.m_input_size) || !reader.read(value.m_input_write_time) || !reader.read(value.m_input_hash)
+				    || !reader.read(value.m_output_size))
+				{
+					return false;
+				}
+
+				m_entries.emplace(std::move(key), value);
+			}
+
+			return true;
+		};
+
+		bool is_read = false;
+		if (!mapped_file::guard_access(
+		        [&]()
+		        {
+			        is_read = read();
+		        })
+		    || !is_read)
+		{
+			m_entries.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool folder_index::write(std::string_view input_folder, std::string_view operation) const
+	{
+		std::ofstream file(m_file_path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			return false;
+		}
+
+		const index_header header{
+		    .m_magic          = index_magic,
+		    .m_format_version = index_format_version,
+		    .m_entry_count    = static_cast<uint32_t>(m_entries.size()),
+		};
+		write_value(file, header);
+		write_string(file, input_folder);
+		write_string(file, operation);
+
+		for (const auto& [key, value] : m_entries)
+		{
+			write_string(file, key);
+			write_value(file, value.m_input_size);
+			write_value(file, value.m_input_write_time);
+			write_value(file, value.m_input_hash);
+			write_value(file, value.m_output_size);
+		}
+
+		return static_cast<bool>(file);
+	}
+
+	const folder_index::entry_map& folder_index::entries() const
+	{
+		return m_entries;
+	}
+
+	void folder_index::set_entries(entry_map entries)
+	{
+		m_entries = std::move(entries);
+	}
+
+	uint64_t hash_file(const std::filesystem::path& path)
+	{
+		mapped_file file;
+		if (!file.open(path))
+		{
+			return 0;
+		}
+
+		uint64_t hash = 0;
+		if (!mapped_file::guard_access(
+		        [&]()
+		        {
+			        hash = XXH64(file.data(), file.size(), 0);
+		        }))
+		{
+			return 0;
+		}
+
+		// Zero means unreadable.
+		return hash | 1;
+	}
+} // namespace big::lz4
@@ -0,0 +1,42 @@
+#pragma once
+
+namespace big::lz4
+{
+	// What the last incremental decompress_folder or compress_folder run made of each input file, saved next to the output folder.
+	// An input whose size and write time are unchanged, or whose content hashes the same, is skipped as long as its output still has the recorded size.
+	class folder_index
+	{
+	public:
+		struct entry
+		{
+			uint64_t m_input_size      = 0;
+			int64_t m_input_write_time = 0;
+			uint64_t m_input_hash      = 0;
+			uint64_t m_output_size     = 0;
+
+			bool operator==(const entry&) const = default;
+		};
+
+		// Keyed by the UTF-8 input path relative to the input folder.
+		using entry_map = std::unordered_map<std::string, entry>;
+
+		explicit folder_index(std::filesystem::path file_path);
+
+		// Where the index of output_folder lives: a sibling file, the folder itself may get fed to another run.
+		static std::filesystem::path get_file_path(const std::filesystem::path& output_folder);
+
+		// Returns false if the file doesn't exist, is from another format version, or was written for another input folder or operation.
+		bool load(std::string_view input_folder, std::string_view operation);
+		bool write(std::string_view input_folder, std::string_view operation) const;
+
+		const entry_map& entries() const;
+		void set_entries(entry_map entries);
+
+	private:
+		std::filesystem::path m_file_path;
+		entry_map m_entries;
+	};
+
+	// Same hash as the one stored in the index entries. Zero if the file can't be read.
+	uint64_t hash_file(const std::filesystem::path& path);
+} // namespace big::lz4
@@ -2,19 +2,27 @@
 #include "dll_proxy/dll_proxy.hpp"
 #include "gui/gui.hpp"
 #include "gui/renderer.hpp"
+#include "hades2/file_stream_registry.hpp"
+#include "hades2/fs_append_path_component.hpp"
+#include "hades2/hades2_signatures.hpp"
 #include "hades2/hooks.hpp"
 #include "hooks/hooking.hpp"
 #include "logger/exception_handler.hpp"
 #include "lua/lua_manager.hpp"
 #include "memory/byte_patch_manager.hpp"
+#include "mod_files/file_existence_cache.hpp"
+#include "mod_files/plugins_data.hpp"
 #include "paths/paths.hpp"
 #include "pointers.hpp"
+#include "profiling/startup_timeline.hpp"
+#include "signatures/signatures.hpp"
 #include "threads/thread_pool.hpp"
 #include "threads/util.hpp"
 #include "version.hpp"
 
 #include <lua_extensions/bindings/hades/hades_ida.hpp>
 #include <lua_extensions/bindings/hades/inputs.hpp>
+#include <lua_extensions/bindings/paths_ext.hpp>
 #include <lua_extensions/bindings/tolk/tolk.hpp>
 #include <memory/gm_address.hpp>
 #include <new>
@@ -75,19 +83,19 @@ struct Table;
 
 static void hook_luaH_free(lua_State *L, Table *t)
 {
-	static auto hades_func = gmAddress::scan("E8 ?? ?? ?? ?? E9 AB 00 00 00 48 8B D3", "hades_luaH_free").get_call().as_func<void(lua_State *, Table *)>();
+	static auto hades_func = big::hades2_symbols::luaH_free.address().as_func<void(lua_State *, Table *)>();
 	return hades_func(L, t);
 }
 
 static __int64 hook_luaH_getn(Table *t)
 {
-	static auto hades_func = gmAddress::scan("48 8B E9 85 DB", "hades_luaH_getn").offset(-0xD).as_func<__int64(Table *)>();
+	static auto hades_func = big::hades2_symbols::luaH_getn.address().as_func<__int64(Table *)>();
 	return hades_func(t);
 }
 
 static Table *hook_luaH_new(lua_State *L)
 {
-	static auto hades_func = gmAddress::scan("44 8D 43 40 E8", "hades_luaH_new").offset(-0x12).as_func<Table *(lua_State *)>();
+	static auto hades_func = big::hades2_symbols::luaH_new.address().as_func<Table *(lua_State *)>();
 	return hades_func(L);
 }
 
@@ -95,25 +103,25 @@ struct TValue;
 
 static TValue *hook_luaH_newkey(lua_State *L, Table *t, const TValue *key)
 {
-	static auto hades_func = gmAddress::scan("83 F8 03 75 15", "hades_luaH_newkey").offset(-0x25).as_func<TValue *(lua_State *, Table *, const TValue *)>();
+	static auto hades_func = big::hades2_symbols::luaH_newkey.address().as_func<TValue *(lua_State *, Table *, const TValue *)>();
 	return hades_func(L, t, key);
 }
 
 static void hook_luaH_resize(lua_State *L, Table *t, int a3, int a4)
 {
-	static auto hades_func = gmAddress::scan("44 3B EF 7E 6A", "hades_luaH_resize").offset(-0x47).as_func<void(lua_State *, Table *, int, int)>();
+	static auto hades_func = big::hades2_symbols::luaH_resize.address().as_func<void(lua_State *, Table *, int, int)>();
 	return hades_func(L, t, a3, a4);
 }
 
 static void hook_luaH_resizearray(lua_State *L, Table *t, int a3)
 {
-	static auto hades_func = gmAddress::scan("E8 ?? ?? ?? ?? 4C 63 FB", "hades_luaH_resizearray").get_call().as_func<void(lua_State *, Table *, int)>();
+	static auto hades_func = big::hades2_symbols::luaH_resizearray.address().as_func<void(lua_State *, Table *, int)>();
 	return hades_func(L, t, a3);
 }
 
 static __int64 hook_setnodevector(lua_State *L, __int64 a2, int a3)
 {
-	static auto hades_func = gmAddress::scan("45 85 C0 75 15", "hades_setnodevector").offset(-0x1E).as_func<__int64(lua_State *, __int64, int)>();
+	static auto hades_func = big::hades2_symbols::setnodevector.address().as_func<__int64(lua_State *, __int64, int)>();
 	return hades_func(L, a2, a3);
 }
 
@@ -209,7 +217,7 @@ static void ForceWrite(T &dst, const T &src)
 
 static void hook_PlayerHandleInput(void *this_, float elapsedSeconds, void *input)
 {
-	static auto jump_stuff = gmAddress::scan("74 7C 38 05").as<uint8_t *>();
+	static auto jump_stuff = big::hades2_symbols::PlayerHandleInput_GUIJump.get();
 
 	if (big::g_gui && big::g_gui->is_open() && !lua::hades::inputs::let_game_input_go_through_gui_layer)
 	{
@@ -349,84 +357,29 @@ static int ends_with(const char *str, const char *suffix)
 	return strncmp(str + lenstr - lensuffix, suffix, lensuffix) == 0;
 }
 
-static bool extension_matches(const char *first, const char *second)
-{
-	auto get_extension = [](const char *str) -> std::string_view
-	{
-		size_t len = strlen(str);
-		std::string_view ext;
-		for (size_t i = 0; i < len; i++)
-		{
-			if (str[i] == '.')
-			{
-				ext = std::string_view(&str[i], &str[len - 1]);
-			}
-		}
-
-		return ext;
-	};
-
-	std::string_view first_ext  = get_extension(first);
-	std::string_view second_ext = get_extension(second);
-
-	if (first_ext.empty() && second_ext.empty())
-	{
-		return true;
-	}
-
-	if (first_ext.empty() || second_ext.empty())
-	{
-		return false;
-	}
-
-	return !strcmp(first_ext.data(), second_ext.data());
-}
-
 // Lua: Enforce AuthorName-ModName to be part of the std::filesystem::path.filename() of the file.
 // See the binding data.cpp file for the implementation.
-std::unordered_map<std::string, std::string> additional_package_files;
-
-std::unordered_map<std::string, std::string> additional_granny_files;
+// The package and granny files themselves are mounted by big::plugins_data.
 
 //static std::string g_current_custom_package_stem;
 
-static void hook_fsAppendPathComponent_packages(const char *basePath, const char *pathComponent, char *output /*size: 512*/)
+static big::hades::fs_append_path_component::handler_result redirect_packages(const char *basePath, const char *pathComponent, char *output /*size: 512*/)
 {
 	//g_current_custom_package_stem = "";
 
-	big::g_hooking->get_original<hook_fsAppendPathComponent_packages>()(basePath, pathComponent, output);
-
 	if (strlen(pathComponent) > 0)
 	{
-		for (const auto &[filename, full_file_path] : additional_package_files)
+		const auto full_file_path = big::plugins_data::get_vfs().resolve(pathComponent);
+		if (full_file_path)
 		{
-			if (strstr(pathComponent, filename.c_str()) && extension_matches(pathComponent, filename.c_str()))
-			{
-				LOG(DEBUG) << pathComponent << " | " << filename << " | " << full_file_path;
-				//g_current_custom_package_stem = (char *)std::filesystem::path(filename).stem().u8string().c_str();
-				strcpy(output, full_file_path.c_str());
-				break;
-			}
-			else if (strstr(filename.c_str(), pathComponent) && extension_matches(pathComponent, filename.c_str()))
-			{
-				LOG(DEBUG) << filename << " | " << pathComponent << " | " << full_file_path;
-				//g_current_custom_package_stem = (char *)std::filesystem::path(filename).stem().u8string().c_str();
-				strcpy(output, full_file_path.c_str());
-				break;
-			}
-		}
-
-		for (const auto &[filename, full_file_path] : additional_granny_files)
-		{
-			if (strstr(pathComponent, filename.c_str()))
-			{
-				LOG(DEBUG) << pathComponent << " | " << filename << " | " << full_file_path;
+			LOG(DEBUG) << pathComponent << " | " << *full_file_path;
+			strcpy(output, full_file_path->c_str());
 
-				strcpy(output, full_file_path.c_str());
-				break;
-			}
+			return big::hades::fs_append_path_component::handler_result::modified;
 		}
 	}
+
+	return big::hades::fs_append_path_component::handler_result::pass;
 }
 
 static void hook_fsGetFilesWithExtension_packages(PVOID resourceDir, const char *subDirectory, wchar_t *extension, eastl::vector<eastl::string> *out)
@@ -457,7 +410,7 @@ static void hook_fsGetFilesWithExtension_packages(PVOID resourceDir, const char
 	bool is_pkg_manifest_only = has_pkg_manifest && !has_pkg;
 	if (is_pkg_manifest_only)
 	{
-		for (const auto &[filename, full_file_path] : additional_package_files)
+		for (const auto &filename : big::plugins_data::get_vfs().get_filenames(big::plugins_data_manifest::file_kind::package))
 		{
 			if (ends_with(filename.c_str(), ".pkg_manifest"))
 			{
@@ -467,14 +420,14 @@ static void hook_fsGetFilesWithExtension_packages(PVOID resourceDir, const char
 	}
 	else if (has_pkg && has_pkg_manifest)
 	{
-		for (const auto &[filename, full_file_path] : additional_package_files)
+		for (const auto &filename : big::plugins_data::get_vfs().get_filenames(big::plugins_data_manifest::file_kind::package))
 		{
 			out->push_back(filename.c_str());
 		}
 	}
 	else if (has_gr2_lz4)
 	{
-		for (const auto &[filename, full_file_path] : additional_granny_files)
+		for (const auto &filename : big::plugins_data::get_vfs().get_filenames(big::plugins_data_manifest::file_kind::granny))
 		{
 			out->push_back(filename.c_str());
 		}
@@ -527,13 +480,28 @@ BOOL APIENTRY DllMain(HMODULE hmod, DWORD reason, PVOID)
 		// Purposely leak it, we are not unloading this module in any case.
 		auto exception_handling = new exception_handler();
 
-		big::hooking::detour_hook_helper::add_now<hook_initRenderer>(
-		    "initRenderer",
-		    gmAddress::scan("E8 ? ? ? ? 90 48 8B 05 ? ? ? ? 48 85 C0", "initRenderer").get_call());
+		startup_timeline::set_thread_name("DllMain");
+		startup_timeline::scoped_span dll_main_span("phase", "DllMain");
 
-		big::hooking::detour_hook_helper::add_now<hook_skipcrashpadinit>(
-		    "backtrace::initializeCrashpad",
-		    gmAddress::scan("74 13 48 8B C8", "backtrace::initializeCrashpad").offset(-0x4C).as_func<bool()>());
+		// Resolve every known signature in one pass over the game code (or from the cache if the game didn't update),
+		// the hades2_symbols handles used below and in the lua bindings are served from it.
+		// g_file_manager is not initialized yet at this point.
+		big::signatures::run_startup_batch(hades2_signatures,
+		                                   std::filesystem::path(paths::get_project_root_folder()) / "cache" / "hades2_signatures.bin");
+
+		{
+			startup_timeline::scoped_span span("hook", "initRenderer");
+			big::hooking::detour_hook_helper::add_now<hook_initRenderer>(
+			    "initRenderer",
+			    big::hades2_symbols::initRenderer.address());
+		}
+
+		{
+			startup_timeline::scoped_span span("hook", "backtrace::initializeCrashpad");
+			big::hooking::detour_hook_helper::add_now<hook_skipcrashpadinit>(
+			    "backtrace::initializeCrashpad",
+			    big::hades2_symbols::initializeCrashpad.get());
+		}
 
 
 		// If that block fails lua will crash.
@@ -541,6 +509,8 @@ BOOL APIENTRY DllMain(HMODULE hmod, DWORD reason, PVOID)
 		// Since the target game statically link against lua, we have to do it too,
 		// a duplicate dummynode_ is made, and will eventually get out of sync.
 		{
+			startup_timeline::scoped_span span("hook", "luaH_* table functions");
+
 			// clang-format off
 			big::hooking::detour_hook_helper::add_now<hook_luaH_free>("luaH_free", &luaH_free);
 			big::hooking::detour_hook_helper::add_now<hook_luaH_getn>("luaH_getn", &luaH_getn);
@@ -552,7 +522,7 @@ BOOL APIENTRY DllMain(HMODULE hmod, DWORD reason, PVOID)
 		}
 
 		/*{
-			static auto GUIComponentTextBox_ctor_ptr = gmAddress::scan("89 BB 2C 06 00 00", "sgg::GUIComponentTextBox::GUIComponentTextBox");
+			static auto GUIComponentTextBox_ctor_ptr = big::signatures::scan("89 BB 2C 06 00 00", "sgg::GUIComponentTextBox::GUIComponentTextBox");
 			if (GUIComponentTextBox_ctor_ptr)
 			{
 				static auto GUIComponentTextBox_ctor = GUIComponentTextBox_ctor_ptr.offset(-0x3B);
@@ -561,10 +531,11 @@ BOOL APIENTRY DllMain(HMODULE hmod, DWORD reason, PVOID)
 		}*/
 
 		{
-			static auto GUIComponentTextBox_update_ptr = gmAddress::scan("76 30 8B 43 74", "sgg::GUIComponentTextBox::Update");
-			if (GUIComponentTextBox_update_ptr)
+			startup_timeline::scoped_span span("hook", "sgg__GUIComponentTextBox__Update");
+
+			static auto GUIComponentTextBox_update = big::hades2_symbols::GUIComponentTextBox_Update.address();
+			if (GUIComponentTextBox_update)
 			{
-				static auto GUIComponentTextBox_update = GUIComponentTextBox_update_ptr.offset(-0x51);
 				static auto hook_ = hooking::detour_hook_helper::add_now<sgg__GUIComponentTextBox__Update>(
 				    "sgg__GUIComponentTextBox__Update",
 				    GUIComponentTextBox_update);
@@ -572,19 +543,21 @@ BOOL APIENTRY DllMain(HMODULE hmod, DWORD reason, PVOID)
 		}
 
 		{
-			static auto GUIComponentTextBox_dctor_ptr = gmAddress::scan("8D 05 ? ? ? ? 48 8B F1 4C 8D B1", "sgg::GUIComponentTextBox::GUIComponentTextBox_dctor");
-			if (GUIComponentTextBox_dctor_ptr)
+			startup_timeline::scoped_span span("hook", "sgg__GUIComponentTextBox__GUIComponentTextBox_dctor");
+
+			static auto GUIComponentTextBox_dctor = big::hades2_symbols::GUIComponentTextBox_dctor.address();
+			if (GUIComponentTextBox_dctor)
 			{
-				static auto GUIComponentTextBox_dctor = GUIComponentTextBox_dctor_ptr.offset(-0x19);
 				static auto hook_ = hooking::detour_hook_helper::add<sgg__GUIComponentTextBox__GUIComponentTextBox_dctor>("sgg__GUIComponentTextBox__GUIComponentTextBox_dctor", GUIComponentTextBox_dctor);
 			}
 		}
 
 		{
-			static auto GUIComponentButton_OnSelected_ptr = gmAddress::scan("8B D9 E8 ? ? ? ? 80 BB AA", "sgg::GUIComponentButton::OnSelected");
-			if (GUIComponentButton_OnSelected_ptr)
+			startup_timeline::scoped_span span("hook", "GUIComponentButton_OnSelected");
+
+			static auto GUIComponentButton_OnSelected = big::hades2_symbols::GUIComponentButton_OnSelected.address();
+			if (GUIComponentButton_OnSelected)
 			{
-				static auto GUIComponentButton_OnSelected = GUIComponentButton_OnSelected_ptr.offset(-0x7);
 				static auto hook_ = hooking::detour_hook_helper::add<hook_GUIComponentButton_OnSelected>(
 				    "GUIComponentButton_OnSelected",
 				    GUIComponentButton_OnSelected);
@@ -592,38 +565,42 @@ BOOL APIENTRY DllMain(HMODULE hmod, DWORD reason, PVOID)
 		}
 
 		{
-			static auto read_anim_data_ptr = gmAddress::scan("BA 2A 00 00 00", "ReadAllAnimationData");
-			if (read_anim_data_ptr)
-			{
-				static auto read_anim_data = read_anim_data_ptr.offset(-0x1'97).as_func<void()>();
+			startup_timeline::scoped_span span("hook", "ReadAllAnimationData Hook");
 
+			static auto read_anim_data = big::hades2_symbols::ReadAllAnimationData.get();
+			if (read_anim_data)
+			{
 				static auto hook_ =
 				    hooking::detour_hook_helper::add<hook_ReadAllAnimationData>("ReadAllAnimationData Hook", read_anim_data);
 			}
 		}
 
 		{
-			//static auto hook_ = hooking::detour_hook_helper::add<hook_HandleInput>("Global HandleInput Hook", gmAddress::scan("40 53 41 56 41 57 48 83 EC 30", "HandleInput"));
-			static auto hook_ = hooking::detour_hook_helper::add<hook_PlayerHandleInput>("Player HandleInput Hook", gmAddress::scan("E8 ? ? ? ? 8B 05 ? ? ? ? 90", "Player HandleInput"));
+			startup_timeline::scoped_span span("hook", "Player HandleInput Hook");
+
+			//static auto hook_ = hooking::detour_hook_helper::add<hook_HandleInput>("Global HandleInput Hook", big::signatures::scan("40 53 41 56 41 57 48 83 EC 30", "HandleInput"));
+			static auto hook_ = hooking::detour_hook_helper::add<hook_PlayerHandleInput>("Player HandleInput Hook", big::hades2_symbols::PlayerHandleInput.address());
 		}
 
 		{
+			startup_timeline::scoped_span span("hook", "registerField<bool> hook / PlatformAnalytics Start");
+
 			static auto hook_ = hooking::detour_hook_helper::add_now<hook_ConfigOption_registerField_bool>(
 			    "registerField<bool> hook",
-			    gmAddress::scan("4C 8B C1 88 5C 24 38", "registerField<bool>").offset(-0x2B));
+			    big::hades2_symbols::registerField_bool.address());
 
 			//
 
 			static auto hook_analy_start =
-			    hooking::detour_hook_helper::add_now<hook_PlatformAnalytics_Start>("PlatformAnalytics Start", gmAddress::scan("4C 8B DC 48 83 EC 48 80 3D", "Analy Start"));
+			    hooking::detour_hook_helper::add_now<hook_PlatformAnalytics_Start>("PlatformAnalytics Start", big::hades2_symbols::PlatformAnalytics_Start.address());
 		}
 
 		{
-			static auto ptr = gmAddress::scan("E8 ? ? ? ? B8 ? ? ? ? EB 05", "sgg::LaunchBugReporter");
-			if (ptr)
-			{
-				static auto ptr_func = ptr.get_call();
+			startup_timeline::scoped_span span("hook", "sgg::LaunchBugReporter F10 Disabler Hook");
 
+			static auto ptr_func = big::hades2_symbols::LaunchBugReporter.address();
+			if (ptr_func)
+			{
 				static auto hook_ = hooking::detour_hook_helper::add<hook_disable_f10_launch>(
 				    "sgg::LaunchBugReporter F10 Disabler Hook",
 				    ptr_func);
@@ -631,11 +608,11 @@ BOOL APIENTRY DllMain(HMODULE hmod, DWORD reason, PVOID)
 		}
 
 		{
-			static auto ptr = gmAddress::scan("E8 ? ? ? ? 48 8B 7D CF", "fsGetFilesWithExtension");
-			if (ptr)
-			{
-				static auto ptr_func = ptr.get_call();
+			startup_timeline::scoped_span span("hook", "fsGetFilesWithExtension for packages and models");
 
+			static auto ptr_func = big::hades2_symbols::fsGetFilesWithExtension.address();
+			if (ptr_func)
+			{
 				static auto hook_ = hooking::detour_hook_helper::add<hook_fsGetFilesWithExtension_packages>(
 				    "fsGetFilesWithExtension for packages and models",
 				    ptr_func);
@@ -643,7 +620,7 @@ BOOL APIENTRY DllMain(HMODULE hmod, DWORD reason, PVOID)
 		}
 
 		/*{
-			static auto ptr = gmAddress::scan("E8 ? ? ? ? 90 49 8B CF", "ReadCSString");
+			static auto ptr = big::signatures::scan("E8 ? ? ? ? 90 49 8B CF", "ReadCSString");
 			if (ptr)
 			{
 				static auto ptr_func = ptr.get_call();
@@ -654,20 +631,16 @@ BOOL APIENTRY DllMain(HMODULE hmod, DWORD reason, PVOID)
 		}*/
 
 		{
-			static auto fsAppendPathComponent_ptr = gmAddress::scan("C6 44 24 30 5C", "fsAppendPathComponent");
-			if (fsAppendPathComponent_ptr)
-			{
-				static auto fsAppendPathComponent = fsAppendPathComponent_ptr.offset(-0x97).as_func<void(const char *, const char *, char *)>();
+			startup_timeline::scoped_span span("hook", "fsAppendPathComponent dispatcher");
 
-				static auto hook_once = big::hooking::detour_hook_helper::add<hook_fsAppendPathComponent_packages>(
-				    "hook_fsAppendPathComponent for packages and models",
-				    fsAppendPathComponent);
-			}
+			// The data and audio bindings register their own handlers once the lua manager is up.
+			big::hades::fs_append_path_component::init_hook();
+			big::hades::fs_append_path_component::add_handler("packages and models redirect", 100, redirect_packages);
 		}
 
 		/*big::hooking::detour_hook_helper::add_now<hook_SGD_Deserialize_ThingDataDef>(
 		    "void __fastcall sgg::SGD_Deserialize(sgg::SGD_Context *ctx, int loc, sgg::ThingDataDef *val)",
-		    gmAddress::scan("44 88 74 24 21", "SGD_Deserialize ThingData").offset(-0x59));*/
+		    big::signatures::scan("44 88 74 24 21", "SGD_Deserialize ThingData").offset(-0x59));*/
 
 		DisableThreadLibraryCalls(hmod);
 		g_hmodule     = hmod;
@@ -681,12 +654,19 @@ BOOL APIENTRY DllMain(HMODULE hmod, DWORD reason, PVOID)
 			    // This also change things like stringstream outputs and add comma to numbers and things like that, we don't want that, so just set locale on the C apis instead.
 			    //std::locale::global(std::locale(".utf8"));
 
+			    startup_timeline::set_thread_name("Init thread");
+
+			    std::optional<startup_timeline::scoped_span> phase_span;
+			    phase_span.emplace("phase", "File manager and config");
+
 			    std::filesystem::path root_folder = paths::get_project_root_folder();
 			    g_file_manager.init(root_folder);
 			    paths::init_dump_file_path();
 
 			    big::config::init_general();
 
+			    phase_span.emplace("phase", "Logger");
+
 			    auto logger_instance = std::make_unique<logger>(rom::g_project_name, g_file_manager.get_project_file("./LogOutput.log"));
 			    static struct logger_cleanup
 			    {
@@ -699,28 +679,8 @@ BOOL APIENTRY DllMain(HMODULE hmod, DWORD reason, PVOID)
 			    LOG(INFO) << rom::g_project_name;
 			    LOGF(INFO, "Build (GIT SHA1): {}", version::GIT_SHA1);
 
-			    // TODO: move this to own file, make sure it's called early enough so that it happens before the initial GameReadData call.
-			    for (const auto &entry :
-			         std::filesystem::recursive_directory_iterator(g_file_manager.get_project_folder("plugins_data").get_path(), std::filesystem::directory_options::skip_permission_denied | std::filesystem::directory_options::follow_directory_symlink))
-			    {
-				    if (entry.path().extension() == ".pkg" || entry.path().extension() == ".pkg_manifest")
-				    {
-					    additional_package_files.emplace((char *)entry.path().filename().u8string().c_str(),
-					                                     (char *)entry.path().u8string().c_str());
-
-					    LOG(INFO) << "Adding to package files: " << (char *)entry.path().u8string().c_str();
-				    }
-				    else if (ends_with((char *)entry.path().u8string().c_str(), ".gr2.lz4"))
-				    {
-					    additional_granny_files.emplace((char *)entry.path().filename().u8string().c_str(),
-					                                    (char *)entry.path().u8string().c_str());
-
-					    LOG(INFO) << "Adding to granny files: " << (char *)entry.path().u8string().c_str();
-				    }
-			    }
-
 			    //static auto ptr_for_cave_test =
-			    //  gmAddress::scan("E8 ? ? ? ? EB 11 41 80 7D ? ?", "ptr_for_cave_test").get_call().offset(0x37);
+			    //  big::signatures::scan("E8 ? ? ? ? EB 11 41 80 7D ? ?", "ptr_for_cave_test").get_call().offset(0x37);
 
 			    // config test
 			    if (0)
@@ -779,31 +739,59 @@ BOOL APIENTRY DllMain(HMODULE hmod, DWORD reason, PVOID)
 			    LOG(INFO) << "This is a final build";
 #endif
 
+			    phase_span.emplace("phase", "Thread pool");
 			    auto thread_pool_instance = std::make_unique<thread_pool>();
 			    LOG(INFO) << "Thread pool initialized.";
 
+			    phase_span.emplace("phase", "plugins_data crawl");
+
+			    // Make sure it's called early enough so that it happens before the initial GameReadData call.
+			    big::plugins_data::refresh();
+
+			    // Game files don't change while the game runs, list them once in the background for the sjson file stream tracking.
+			    g_thread_pool->push(
+			        []
+			        {
+				        startup_timeline::scoped_span span("phase", "Content folder listing");
+				        big::g_file_existence_cache.seed(lua::paths_ext::get_content_folder());
+			        });
+
+			    phase_span.emplace("phase", "Deferred signatures");
+			    big::signatures::run_deferred_batch();
+			    big::signatures::log_startup_batch_report();
+
+			    phase_span.emplace("phase", "Pointers");
 			    auto pointers_instance = std::make_unique<pointers>();
 			    LOG(INFO) << "Pointers initialized.";
 
+			    phase_span.emplace("phase", "Byte Patch Manager");
 			    auto byte_patch_manager_instance = std::make_unique<byte_patch_manager>();
 			    LOG(INFO) << "Byte Patch Manager initialized.";
 
+			    phase_span.emplace("phase", "Hooking");
 			    auto hooking_instance = std::make_unique<hooking>();
 			    LOG(INFO) << "Hooking initialized.";
 
+			    phase_span.emplace("phase", "hades::init_hooks");
 			    big::hades::init_hooks();
 
+			    phase_span.emplace("phase", "Renderer");
 			    auto renderer_instance = std::make_unique<renderer>();
 			    LOG(INFO) << "Renderer initialized.";
 
+			    phase_span.emplace("phase", "Hotkeys");
 			    hotkey::init_hotkeys();
 
 			    if (!g_abort)
 			    {
+				    phase_span.emplace("phase", "Hooking enable");
 				    g_hooking->enable();
 				    LOG(INFO) << "Hooking enabled.";
 			    }
 
+			    // The trace itself is written once the mods are loaded, see hades::lua::hook_in.
+			    phase_span.reset();
+
 			    g_running = true;
 
 			    if (g_abort)
@@ -820,6 +808,16 @@ BOOL APIENTRY DllMain(HMODULE hmod, DWORD reason, PVOID)
 			    g_hooking->disable();
 			    LOG(INFO) << "Hooking disabled.";
 
+			    big::hades::fs_append_path_component::log_handler_stats();
+
+			    const auto file_stream_registry_stats = big::hades::g_file_stream_registry.get_stats();
+			    LOGF(INFO,
+			         "FileStream registry: {} live entries, {} inserts, {} erases, {} contended locks",
+			         file_stream_registry_stats.m_live_entry_count,
+			         file_stream_registry_stats.m_insert_count,
+			         file_stream_registry_stats.m_erase_count,
+			         file_stream_registry_stats.m_contention_count);
+
 			    // Make sure that all threads created don't have any blocking loops
 			    // otherwise make sure that they have stopped executing
 			    thread_pool_instance->destroy();
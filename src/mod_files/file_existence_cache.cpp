@@ -0,0 +1,109 @@
+#include "file_existence_cache.hpp"
+
+namespace big
+{
+	std::string file_existence_cache::normalize(std::string_view path)
+	{
+		std::string res(path);
+		for (auto& c : res)
+		{
+			if (c == '\\')
+			{
+				c = '/';
+			}
+			else if (c >= 'A' && c <= 'Z')
+			{
+				c += 'a' - 'A';
+			}
+		}
+
+		while (res.size() > 1 && res.back() == '/')
+		{
+			res.pop_back();
+		}
+
+		return res;
+	}
+
+	std::string file_existence_cache::normalize(const std::filesystem::path& path)
+	{
+		return normalize(std::string_view((char*)path.u8string().c_str()));
+	}
+
+	bool file_existence_cache::exists(std::string_view file_path)
+	{
+		const auto normalized_path = normalize(file_path);
+		const auto last_separator  = normalized_path.rfind('/');
+		if (last_separator == std::string::npos)
+		{
+			return false;
+		}
+
+		const std::string_view directory(normalized_path.data(), last_separator);
+		const std::string_view filename = std::string_view(normalized_path).substr(last_separator + 1);
+
+		{
+			std::shared_lock l(m_mutex);
+
+			const auto it = m_directories.find(directory);
+			if (it != m_directories.end())
+			{
+				return it->second.contains(filename);
+			}
+		}
+
+		// A directory that can't be listed is remembered as empty.
+		filename_set filenames;
+		std::error_code ec;
+		const auto directory_path = std::filesystem::path(std::u8string_view(reinterpret_cast<const char8_t*>(file_path.data()), file_path.size())).parent_path();
+		for (const auto& entry : std::filesystem::directory_iterator(directory_path, std::filesystem::directory_options::skip_permission_denied, ec))
+		{
+			filenames.insert(normalize(entry.path().filename()));
+		}
+
+		const auto res = filenames.contains(filename);
+
+		std::unique_lock l(m_mutex);
+		m_directories.insert_or_assign(std::string(directory), std::move(filenames));
+
+		return res;
+	}
+
+	void file_existence_cache::seed(const std::filesystem::path& folder)
+	{
+		std::unordered_map<std::string, filename_set, string_hash, std::equal_to<>> directories;
+		directories[normalize(folder)];
+
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(folder, std::filesystem::directory_options::skip_permission_denied, ec))
+		{
+			if (entry.is_directory(ec))
+			{
+				directories[normalize(entry.path())];
+			}
+			else
+			{
+				directories[normalize(entry.path().parent_path())].insert(normalize(entry.path().filename()));
+			}
+		}
+
+		std::unique_lock l(m_mutex);
+		for (auto& [directory, filenames] : directories)
+		{
+			m_directories.insert_or_assign(directory, std::move(filenames));
+		}
+	}
+
+	void file_existence_cache::invalidate(const std::filesystem::path& folder)
+	{
+		const auto normalized_folder = normalize(folder);
+
+		std::unique_lock l(m_mutex);
+		std::erase_if(m_directories,
+		              [&normalized_folder](const auto& directory)
+		              {
+			              const std::string_view path = directory.first;
+			              return path.starts_with(normalized_folder) && (path.size() == normalized_folder.size() || path[normalized_folder.size()] == '/');
+		              });
+	}
+} // namespace big
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <shared_mutex>
+#include <unordered_set>
+
+namespace big
+{
+	// Answers whether a file exists from directory listings kept in memory.
+	// A directory is listed at most once until invalidated, so asking again about any file in it never touches the disk.
+	// Paths are compared case insensitively (ASCII only) and with either separator, like the file system does.
+	class file_existence_cache
+	{
+	public:
+		// file_path is UTF-8, the directory holding it gets listed the first time something in it is asked about.
+		bool exists(std::string_view file_path);
+
+		// Lists folder and every directory under it ahead of time.
+		void seed(const std::filesystem::path& folder);
+
+		// Forgets the listings of folder and of every directory under it.
+		void invalidate(const std::filesystem::path& folder);
+
+	private:
+		struct string_hash
+		{
+			using is_transparent = void;
+
+			size_t operator()(std::string_view str) const
+			{
+				return std::hash<std::string_view>{}(str);
+			}
+		};
+
+		using filename_set = std::unordered_set<std::string, string_hash, std::equal_to<>>;
+
+		static std::string normalize(std::string_view path);
+		static std::string normalize(const std::filesystem::path& path);
+
+		std::shared_mutex m_mutex;
+		// Normalized directory path → normalized names of the files in it.
+		std::unordered_map<std::string, filename_set, string_hash, std::equal_to<>> m_directories;
+	};
+
+	inline file_existence_cache g_file_existence_cache;
+} // namespace big
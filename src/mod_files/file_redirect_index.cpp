@@ -0,0 +1,84 @@
+#include "file_redirect_index.hpp"
+
+namespace big
+{
+	// Everything from the last dot, empty when there is none or when the dot is the last character.
+	static std::string_view get_last_extension(std::string_view str)
+	{
+		const auto dot = str.rfind('.');
+		return dot == std::string_view::npos || dot + 1 == str.size() ? std::string_view{} : str.substr(dot);
+	}
+
+	void file_redirect_index::add_package(std::string_view filename, std::string_view full_file_path)
+	{
+		m_packages.emplace_back(std::string(filename), std::string(full_file_path));
+	}
+
+	void file_redirect_index::add_granny(std::string_view filename, std::string_view full_file_path)
+	{
+		m_granny_files.emplace_back(std::string(filename), std::string(full_file_path));
+	}
+
+	void file_redirect_index::build()
+	{
+		m_package_groups.clear();
+		for (uint32_t i = 0; i < m_packages.size(); i++)
+		{
+			const auto extension = get_last_extension(m_packages[i].m_filename);
+
+			auto group_it = std::ranges::find(m_package_groups, extension, &package_group::m_extension);
+			if (group_it == m_package_groups.end())
+			{
+				group_it              = m_package_groups.emplace(m_package_groups.end());
+				group_it->m_extension = extension;
+			}
+
+			group_it->m_entry_indices.push_back(i);
+		}
+
+		std::vector<std::string_view> keys;
+		for (auto& group : m_package_groups)
+		{
+			keys.clear();
+			for (const auto entry_index : group.m_entry_indices)
+			{
+				keys.push_back(m_packages[entry_index].m_filename);
+			}
+
+			group.m_index.build(keys);
+		}
+
+		keys.clear();
+		for (const auto& entry : m_granny_files)
+		{
+			keys.push_back(entry.m_filename);
+		}
+
+		m_granny_index.build(keys);
+	}
+
+	const std::string* file_redirect_index::find(std::string_view path_component) const
+	{
+		const auto granny_index = m_granny_index.find_key_in(path_component);
+		if (granny_index != substring_index::npos)
+		{
+			return &m_granny_files[granny_index].m_full_file_path;
+		}
+
+		const auto group_it = std::ranges::find(m_package_groups, get_last_extension(path_component), &package_group::m_extension);
+		if (group_it == m_package_groups.end())
+		{
+			return nullptr;
+		}
+
+		const auto& group = *group_it;
+
+		const auto best = std::min(group.m_index.find_key_in(path_component), group.m_index.find_key_containing(path_component));
+		if (best == substring_index::npos)
+		{
+			return nullptr;
+		}
+
+		return &m_packages[group.m_entry_indices[best]].m_full_file_path;
+	}
+} // namespace big
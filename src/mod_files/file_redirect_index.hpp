@@ -0,0 +1,45 @@
+#pragma once
+
+#include "substring_index.hpp"
+
+namespace big
+{
+	// Which plugins_data file, if any, a path component handed to fsAppendPathComponent gets redirected to.
+	// Built once from the plugins_data crawl, each lookup is then linear in the path component length whatever the number of mod files.
+	class file_redirect_index
+	{
+	public:
+		void add_package(std::string_view filename, std::string_view full_file_path);
+		void add_granny(std::string_view filename, std::string_view full_file_path);
+
+		// Must be called once every file is added, and before any find() call.
+		void build();
+
+		// A package file matches when its filename is part of the path component or the other way around, provided that both end with the same extension.
+		// A granny file matches when its filename is part of the path component, and takes precedence over package files.
+		// When multiple files match, the first one added wins.
+		const std::string* find(std::string_view path_component) const;
+
+	private:
+		struct file_entry
+		{
+			std::string m_filename;
+			std::string m_full_file_path;
+		};
+
+		// Package files are grouped by extension, so that the extension check never has to reject a match.
+		struct package_group
+		{
+			std::string m_extension;
+			std::vector<uint32_t> m_entry_indices;
+			substring_index m_index;
+		};
+
+		std::vector<file_entry> m_packages;
+		// Only a handful of extensions (.pkg, .pkg_manifest), a linear search beats hashing the lookup extension.
+		std::vector<package_group> m_package_groups;
+
+		std::vector<file_entry> m_granny_files;
+		substring_index m_granny_index;
+	};
+} // namespace big
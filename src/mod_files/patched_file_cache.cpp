@@ -0,0 +1,156 @@
+#include "patched_file_cache.hpp"
+
+#include <files/mapped_file.hpp>
+#include <lz4.h>
+
+namespace big
+{
+	// Bump when the layout of the file changes.
+	static constexpr uint32_t cache_format_version = 1;
+	static constexpr uint32_t cache_magic          = 0x43'50'32'48; // "H2PC"
+
+#pragma pack(push, 1)
+
+	struct cache_header
+	{
+		uint32_t m_magic;
+		uint32_t m_format_version;
+		uint64_t m_key;
+		uint32_t m_decompressed_size;
+		uint32_t m_compressed_size;
+	};
+
+#pragma pack(pop)
+
+	patched_file_cache::patched_file_cache(std::filesystem::path folder) :
+	    m_folder(std::move(folder))
+	{
+	}
+
+	std::filesystem::path patched_file_cache::get_file_path(uint64_t key) const
+	{
+		return m_folder / std::format("{:016X}.lz4", key);
+	}
+
+	std::optional<std::string> patched_file_cache::get(uint64_t key)
+	{
+		// Decompressed straight out of the mapping.
+		mapped_file file;
+		if (!file.open(get_file_path(key)))
+		{
+			m_miss_count++;
+			return std::nullopt;
+		}
+
+		// A file failing to read is a miss, the header then stays zeroed.
+		cache_header header{};
+		if (file.size() >= sizeof(header))
+		{
+			mapped_file::guard_access(
+			    [&]()
+			    {
+				    memcpy(&header, file.data(), sizeof(header));
+			    });
+		}
+
+		// The header isn't trusted: lz4 can't do better than 255 to 1, a bigger decompressed size would only allocate for nothing.
+		if (file.size() < sizeof(header) || header.m_magic != cache_magic || header.m_format_version != cache_format_version || header.m_key != key
+		    || header.m_compressed_size > static_cast<uint32_t>(LZ4_compressBound(static_cast<int>(header.m_decompressed_size)))
+		    || static_cast<uint64_t>(header.m_decompressed_size) > static_cast<uint64_t>(header.m_compressed_size) * 255 + 16
+		    || file.size() - sizeof(header) < header.m_compressed_size)
+		{
+			m_miss_count++;
+			return std::nullopt;
+		}
+
+		std::string res(header.m_decompressed_size, '\0');
+		int decompressed_size = -1;
+		mapped_file::guard_access(
+		    [&]()
+		    {
+			    decompressed_size = LZ4_decompress_safe(file.data() + sizeof(header), res.data(), static_cast<int>(header.m_compressed_size), static_cast<int>(res.size()));
+		    });
+		if (decompressed_size != static_cast<int>(res.size()))
+		{
+			m_miss_count++;
+			return std::nullopt;
+		}
+
+		m_hit_count++;
+		return res;
+	}
+
+	void patched_file_cache::set(uint64_t key, std::string_view patched_data)
+	{
+		if (patched_data.size() > LZ4_MAX_INPUT_SIZE)
+		{
+			return;
+		}
+
+		std::vector<char> compressed(LZ4_compressBound(static_cast<int>(patched_data.size())));
+		const auto compressed_size =
+		    LZ4_compress_default(patched_data.data(), compressed.data(), static_cast<int>(patched_data.size()), static_cast<int>(compressed.size()));
+
+		std::error_code ec;
+		std::filesystem::create_directories(m_folder, ec);
+
+		// Written next to it first, a reader never sees a partially written entry.
+		const auto file_path = get_file_path(key);
+		auto temp_file_path  = file_path;
+		temp_file_path      += ".tmp";
+
+		bool is_written = false;
+		{
+			std::ofstream file(temp_file_path, std::ios::binary | std::ios::trunc);
+			if (file.is_open() && compressed_size > 0)
+			{
+				const cache_header header{
+				    .m_magic             = cache_magic,
+				    .m_format_version    = cache_format_version,
+				    .m_key               = key,
+				    .m_decompressed_size = static_cast<uint32_t>(patched_data.size()),
+				    .m_compressed_size   = static_cast<uint32_t>(compressed_size),
+				};
+				file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				file.write(compressed.data(), compressed_size);
+
+				is_written = static_cast<bool>(file);
+			}
+		}
+
+		if (is_written)
+		{
+			std::filesystem::rename(temp_file_path, file_path, ec);
+			is_written = !ec;
+		}
+
+		if (is_written)
+		{
+			m_write_count++;
+		}
+		else
+		{
+			std::filesystem::remove(temp_file_path, ec);
+			m_write_failed_count++;
+		}
+	}
+
+	void patched_file_cache::invalidate()
+	{
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::directory_iterator(m_folder, ec))
+		{
+			std::filesystem::remove(entry.path(), ec);
+		}
+	}
+
+	patched_file_cache::stats patched_file_cache::get_stats() const
+	{
+		return {
+		    .m_hit_count          = m_hit_count.load(),
+		    .m_miss_count         = m_miss_count.load(),
+		    .m_write_count        = m_write_count.load(),
+		    .m_write_failed_count = m_write_failed_count.load(),
+		};
+	}
+} // namespace big
@@ -0,0 +1,38 @@
+#pragma once
+
+namespace big
+{
+	// Outputs of the mod patches applied to game files, saved to disk lz4 compressed so that a later launch can serve them without running the patches again.
+	// The caller hashes everything the output depends on into the key, an entry never gets stale on its own.
+	class patched_file_cache
+	{
+	public:
+		struct stats
+		{
+			uint64_t m_hit_count          = 0;
+			uint64_t m_miss_count         = 0;
+			uint64_t m_write_count        = 0;
+			uint64_t m_write_failed_count = 0;
+		};
+
+		explicit patched_file_cache(std::filesystem::path folder);
+
+		std::optional<std::string> get(uint64_t key);
+		void set(uint64_t key, std::string_view patched_data);
+
+		// Deletes every cached output.
+		void invalidate();
+
+		stats get_stats() const;
+
+	private:
+		std::filesystem::path get_file_path(uint64_t key) const;
+
+		std::filesystem::path m_folder;
+
+		std::atomic<uint64_t> m_hit_count{0};
+		std::atomic<uint64_t> m_miss_count{0};
+		std::atomic<uint64_t> m_write_count{0};
+		std::atomic<uint64_t> m_write_failed_count{0};
+	};
+} // namespace big
@@ -0,0 +1,108 @@
+#include "plugins_data.hpp"
+
+#include "file_existence_cache.hpp"
+#include "lua/lua_manager.hpp"
+#include "paths/paths.hpp"
+#include "profiling/startup_timeline.hpp"
+#include "threads/thread_pool.hpp"
+
+namespace big::plugins_data
+{
+	static std::mutex g_refresh_mutex;
+	static vfs_overlay g_vfs;
+
+	static std::vector<vfs_overlay::layer> make_layers(const std::vector<plugins_data_manifest::file>& files)
+	{
+		std::vector<vfs_overlay::layer> layers;
+		for (const auto& file : files)
+		{
+			// No folder can be named ".", files right under plugins_data get their own layer.
+			const std::string_view layer_name = file.m_mod_folder.size() ? file.m_mod_folder : ".";
+
+			auto layer_it = std::ranges::find(layers, layer_name, &vfs_overlay::layer::m_name);
+			if (layer_it == layers.end())
+			{
+				layer_it             = layers.emplace(layers.end());
+				layer_it->m_name     = layer_name;
+				layer_it->m_priority = static_cast<int32_t>(layers.size() - 1);
+			}
+
+			layer_it->m_files.push_back(file);
+		}
+
+		return layers;
+	}
+
+	void refresh()
+	{
+		std::scoped_lock l(g_refresh_mutex);
+
+		static plugins_data_manifest manifest(std::filesystem::path(paths::get_project_root_folder()) / "cache" / "plugins_data_manifest.bin");
+		manifest.crawl(g_file_manager.get_project_folder("plugins_data").get_path(),
+		               [](std::function<void()> work)
+		               {
+			               g_thread_pool->push(
+			                   [work = std::move(work)]
+			                   {
+				                   startup_timeline::scoped_span span("phase", "plugins_data crawl worker");
+				                   work();
+			                   });
+		               });
+
+		const auto& crawl_stats = manifest.stats();
+		LOGF(INFO,
+		     "plugins_data crawl: {} files, {} directories listed, {} reused from the manifest{}, {}ms",
+		     manifest.files().size(),
+		     crawl_stats.m_listed_directory_count,
+		     crawl_stats.m_reused_directory_count,
+		     crawl_stats.m_manifest_loaded ? "" : " (no usable manifest)",
+		     crawl_stats.m_duration.count() / 1'000);
+		if (crawl_stats.m_manifest_write_failed)
+		{
+			LOG(WARNING) << "Failed to write the plugins_data manifest.";
+		}
+
+		// Mod files may have been added or removed since the listings got cached.
+		if (crawl_stats.m_listed_directory_count)
+		{
+			g_file_existence_cache.invalidate(g_file_manager.get_project_folder("plugins_data").get_path());
+		}
+
+		const auto mount_stats = g_vfs.mount(make_layers(manifest.files()));
+		LOGF(INFO, "plugins_data overlay: {} mod folders remounted, {} file names resolved again", mount_stats.m_changed_layer_count, mount_stats.m_touched_file_count);
+
+		if (!mount_stats.m_changed_layer_count)
+		{
+			return;
+		}
+
+		for (const auto& file : manifest.files())
+		{
+			if (file.m_kind == plugins_data_manifest::file_kind::package)
+			{
+				LOG(INFO) << "Adding to package files: " << file.m_full_file_path;
+			}
+			else
+			{
+				LOG(INFO) << "Adding to granny files: " << file.m_full_file_path;
+			}
+		}
+
+		for (const auto& conflict : g_vfs.get_conflicts())
+		{
+			std::string shadowed_layers;
+			for (const auto& shadowed_layer : conflict.m_shadowed_layers)
+			{
+				shadowed_layers += shadowed_layers.empty() ? shadowed_layer : ", " + shadowed_layer;
+			}
+
+			LOG(WARNING) << conflict.m_filename << " is provided by multiple mod folders, using the one from " << conflict.m_winner_layer
+			             << " over " << shadowed_layers;
+		}
+	}
+
+	const vfs_overlay& get_vfs()
+	{
+		return g_vfs;
+	}
+} // namespace big::plugins_data
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "vfs_overlay.hpp"
+
+namespace big::plugins_data
+{
+	// Crawls plugins_data and mounts each mod folder as a layer of the overlay, earlier folders in listing order win conflicts.
+	// Mod folders whose files didn't change since the previous call are left untouched. Needs the thread pool.
+	void refresh();
+
+	const vfs_overlay& get_vfs();
+} // namespace big::plugins_data
@@ -0,0 +1,334 @@
+#include "plugins_data_manifest.hpp"
+
+#include <files/mapped_file.hpp>
+
+namespace big
+{
+	// Bump when the layout of the file changes.
+	static constexpr uint32_t manifest_format_version = 1;
+	static constexpr uint32_t manifest_magic          = 0x4D'50'32'48; // "H2PM"
+
+#pragma pack(push, 1)
+
+	struct manifest_header
+	{
+		uint32_t m_magic;
+		uint32_t m_format_version;
+		uint32_t m_directory_count;
+	};
+
+#pragma pack(pop)
+
+	// Bounds checked reads over the whole file, any failure makes the manifest get thrown away.
+	class manifest_reader
+	{
+	public:
+		explicit manifest_reader(std::string_view data) :
+		    m_data(data)
+		{
+		}
+
+		template<typename T>
+		bool read(T& value)
+		{
+			if (m_data.size() - m_cursor < sizeof(T))
+			{
+				return false;
+			}
+
+			memcpy(&value, m_data.data() + m_cursor, sizeof(T));
+			m_cursor += sizeof(T);
+			return true;
+		}
+
+		bool read_string(std::string& value)
+		{
+			uint32_t size = 0;
+			if (!read(size) || m_data.size() - m_cursor < size)
+			{
+				return false;
+			}
+
+			value.assign(m_data.data() + m_cursor, size);
+			m_cursor += size;
+			return true;
+		}
+
+	private:
+		std::string_view m_data;
+		size_t m_cursor = 0;
+	};
+
+	template<typename T>
+	static void write_value(std::ofstream& file, const T& value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	static void write_string(std::ofstream& file, std::string_view value)
+	{
+		write_value(file, static_cast<uint32_t>(value.size()));
+		file.write(value.data(), value.size());
+	}
+
+	static std::string to_utf8(const std::filesystem::path& path)
+	{
+		return (char*)path.u8string().c_str();
+	}
+
+	static std::filesystem::path from_utf8(std::string_view utf8)
+	{
+		return std::u8string_view(reinterpret_cast<const char8_t*>(utf8.data()), utf8.size());
+	}
+
+	plugins_data_manifest::plugins_data_manifest(std::filesystem::path file_path) :
+	    m_file_path(std::move(file_path))
+	{
+	}
+
+	void plugins_data_manifest::crawl(const std::filesystem::path& plugins_data_folder, const spawn_worker_t& spawn_worker)
+	{
+		const auto start_time = std::chrono::high_resolution_clock::now();
+
+		m_stats                   = {};
+		m_stats.m_manifest_loaded = load();
+
+		crawl_result root_result;
+		const auto root = get_directory(plugins_data_folder, root_result);
+
+		std::vector<std::filesystem::path> job_folders;
+		if (root)
+		{
+			for (const auto& child : root->m_children)
+			{
+				if (child.m_kind == child_kind::directory)
+				{
+					job_folders.push_back(plugins_data_folder / from_utf8(child.m_name));
+				}
+			}
+		}
+
+		std::vector<crawl_result> job_results(job_folders.size());
+		run_parallel_jobs(job_folders.size(),
+		                  std::thread::hardware_concurrency(),
+		                  spawn_worker,
+		                  [&](size_t job)
+		                  {
+			                  crawl_directory(job_folders[job], job_results[job]);
+		                  });
+
+		// Stitch everything back in listing order.
+		m_files.clear();
+		if (root)
+		{
+			size_t job = 0;
+			for (const auto& child : root->m_children)
+			{
+				if (child.m_kind == child_kind::directory)
+				{
+					auto& job_files = job_results[job++].m_files;
+					for (auto& job_file : job_files)
+					{
+						job_file.m_mod_folder = child.m_name;
+					}
+					m_files.insert(m_files.end(), std::make_move_iterator(job_files.begin()), std::make_move_iterator(job_files.end()));
+				}
+				else
+				{
+					m_files.emplace_back(child.m_name,
+					                     to_utf8(plugins_data_folder / from_utf8(child.m_name)),
+					                     child.m_kind == child_kind::package ? file_kind::package : file_kind::granny);
+				}
+			}
+		}
+
+		m_stats.m_reused_directory_count = root_result.m_reused_directory_count;
+		m_stats.m_listed_directory_count = root_result.m_listed_directory_count;
+		for (auto& job_result : job_results)
+		{
+			m_stats.m_reused_directory_count += job_result.m_reused_directory_count;
+			m_stats.m_listed_directory_count += job_result.m_listed_directory_count;
+			root_result.m_directories.merge(job_result.m_directories);
+		}
+
+		// A removed directory always changes the time of its parent, so nothing listed means nothing changed.
+		const auto is_dirty = m_stats.m_listed_directory_count || root_result.m_directories.size() != m_directories.size();
+		m_directories       = std::move(root_result.m_directories);
+		if (is_dirty)
+		{
+			m_stats.m_manifest_write_failed = !write();
+		}
+
+		m_stats.m_duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start_time);
+	}
+
+	const std::vector<plugins_data_manifest::file>& plugins_data_manifest::files() const
+	{
+		return m_files;
+	}
+
+	const plugins_data_manifest::crawl_stats& plugins_data_manifest::stats() const
+	{
+		return m_stats;
+	}
+
+	void plugins_data_manifest::crawl_directory(const std::filesystem::path& path, crawl_result& result) const
+	{
+		const auto dir = get_directory(path, result);
+		if (!dir)
+		{
+			return;
+		}
+
+		for (const auto& child : dir->m_children)
+		{
+			auto child_path = path / from_utf8(child.m_name);
+			if (child.m_kind == child_kind::directory)
+			{
+				crawl_directory(child_path, result);
+			}
+			else
+			{
+				result.m_files.emplace_back(child.m_name, to_utf8(child_path), child.m_kind == child_kind::package ? file_kind::package : file_kind::granny);
+			}
+		}
+	}
+
+	const plugins_data_manifest::directory* plugins_data_manifest::get_directory(const std::filesystem::path& path, crawl_result& result) const
+	{
+		std::error_code ec;
+		const auto last_write_time = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+		if (ec)
+		{
+			return nullptr;
+		}
+
+		auto key = to_utf8(path);
+
+		const auto cached_it = m_directories.find(key);
+		if (cached_it != m_directories.end() && cached_it->second.m_last_write_time == last_write_time)
+		{
+			result.m_reused_directory_count++;
+			return &result.m_directories.emplace(std::move(key), cached_it->second).first->second;
+		}
+
+		result.m_listed_directory_count++;
+
+		directory dir;
+		dir.m_last_write_time = last_write_time;
+		for (const auto& entry : std::filesystem::directory_iterator(path, std::filesystem::directory_options::skip_permission_denied, ec))
+		{
+			std::string filename = (char*)entry.path().filename().u8string().c_str();
+
+			// Follows symlinks, same as the recursive crawl this replaces.
+			if (entry.is_directory(ec))
+			{
+				dir.m_children.emplace_back(child_kind::directory, std::move(filename));
+			}
+			else if (filename.ends_with(".pkg") || filename.ends_with(".pkg_manifest"))
+			{
+				dir.m_children.emplace_back(child_kind::package, std::move(filename));
+			}
+			else if (filename.ends_with(".gr2.lz4"))
+			{
+				dir.m_children.emplace_back(child_kind::granny, std::move(filename));
+			}
+		}
+
+		return &result.m_directories.insert_or_assign(std::move(key), std::move(dir)).first->second;
+	}
+
+	bool plugins_data_manifest::load()
+	{
+		m_directories.clear();
+
+		mapped_file file;
+		if (!file.open(m_file_path))
+		{
+			return false;
+		}
+
+		// A file failing to read midway is no manifest either.
+		const auto read = [&]()
+		{
+			manifest_reader reader(file.view());
+
+			manifest_header header{};
+			if (!reader.read(header) || header.m_magic != manifest_magic || header.m_format_version != manifest_format_version)
+			{
+				return false;
+			}
+
+			for (uint32_t i = 0; i < header.m_directory_count; i++)
+			{
+				std::string path;
+				directory dir;
+				uint32_t child_count = 0;
+				if (!reader.read_string(path) || !reader.read(dir.m_last_write_time) || !reader.read(child_count))
+				{
+					return false;
+				}
+
+				for (uint32_t j = 0; j < child_count; j++)
+				{
+					auto& child = dir.m_children.emplace_back();
+					if (!reader.read(child.m_kind) || child.m_kind > child_kind::directory || !reader.read_string(child.m_name))
+					{
+						return false;
+					}
+				}
+
+				m_directories.emplace(std::move(path), std::move(dir));
+			}
+
+			return true;
+		};
+
+		bool is_read = false;
+		if (!mapped_file::guard_access(
+		        [&]()
+		        {
+			        is_read = read();
+		        })
+		    || !is_read)
+		{
+			m_directories.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool plugins_data_manifest::write() const
+	{
+		std::error_code ec;
+		std::filesystem::create_directories(m_file_path.parent_path(), ec);
+
+		std::ofstream file(m_file_path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			return false;
+		}
+
+		const manifest_header header{
+		    .m_magic           = manifest_magic,
+		    .m_format_version  = manifest_format_version,
+		    .m_directory_count = static_cast<uint32_t>(m_directories.size()),
+		};
+		write_value(file, header);
+
+		for (const auto& [path, dir] : m_directories)
+		{
+			write_string(file, path);
+			write_value(file, dir.m_last_write_time);
+			write_value(file, static_cast<uint32_t>(dir.m_children.size()));
+			for (const auto& child : dir.m_children)
+			{
+				write_value(file, child.m_kind);
+				write_string(file, child.m_name);
+			}
+		}
+
+		return static_cast<bool>(file);
+	}
+} // namespace big
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <threads/parallel_jobs.hpp>
+
+namespace big
+{
+	// Every plugins_data file the game may get redirected to, along with the directory tree they were found in.
+	// The tree is saved to disk so that the next launch only lists the directories whose last write time changed,
+	// which happens whenever one of their direct children gets added, removed or renamed.
+	// An unchanged mod set then costs one stat per directory and none per file.
+	class plugins_data_manifest
+	{
+	public:
+		enum class file_kind : uint8_t
+		{
+			package,
+			granny,
+		};
+
+		struct file
+		{
+			std::string m_filename;
+			std::string m_full_file_path;
+			file_kind m_kind;
+			// Name of the top level plugins_data folder the file is in, empty for files right under plugins_data.
+			std::string m_mod_folder;
+
+			bool operator==(const file&) const = default;
+		};
+
+		struct crawl_stats
+		{
+			bool m_manifest_loaded          = false;
+			bool m_manifest_write_failed    = false;
+			size_t m_reused_directory_count = 0;
+			size_t m_listed_directory_count = 0;
+			std::chrono::microseconds m_duration{};
+		};
+
+		explicit plugins_data_manifest(std::filesystem::path file_path);
+
+		// Each top level folder of plugins_data (one per mod) is crawled as its own job, spawn_worker hands a worker to another thread.
+		// The calling thread works too, so this returns even if no spawned worker ever gets to run.
+		// The manifest file is rewritten if anything changed.
+		void crawl(const std::filesystem::path& plugins_data_folder, const spawn_worker_t& spawn_worker);
+
+		// In the order a recursive_directory_iterator over plugins_data would have yielded them.
+		const std::vector<file>& files() const;
+
+		const crawl_stats& stats() const;
+
+	private:
+		enum class child_kind : uint8_t
+		{
+			package,
+			granny,
+			directory,
+		};
+
+		struct child
+		{
+			child_kind m_kind;
+			// UTF-8
+			std::string m_name;
+		};
+
+		struct directory
+		{
+			int64_t m_last_write_time = 0;
+			// Only subdirectories and the files we care about, in listing order.
+			std::vector<child> m_children;
+		};
+
+		// Keyed by the UTF-8 full path of the directory.
+		using directory_map = std::unordered_map<std::string, directory>;
+
+		struct crawl_result
+		{
+			directory_map m_directories;
+			std::vector<file> m_files;
+			size_t m_reused_directory_count = 0;
+			size_t m_listed_directory_count = 0;
+		};
+
+		bool load();
+		bool write() const;
+
+		void crawl_directory(const std::filesystem::path& path, crawl_result& result) const;
+		const directory* get_directory(const std::filesystem::path& path, crawl_result& result) const;
+
+		std::filesystem::path m_file_path;
+		directory_map m_directories;
+		std::vector<file> m_files;
+		crawl_stats m_stats;
+	};
+} // namespace big
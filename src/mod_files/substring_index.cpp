@@ -0,0 +1,281 @@
+#include "substring_index.hpp"
+
+#include <bit>
+#include <numeric>
+
+namespace big
+{
+	static constexpr uint32_t no_key = std::numeric_limits<uint32_t>::max();
+
+	static uint32_t find_edge(const std::vector<std::pair<uint8_t, uint32_t>>& edges, uint8_t byte)
+	{
+		for (const auto& [edge_byte, next] : edges)
+		{
+			if (edge_byte == byte)
+			{
+				return next;
+			}
+		}
+
+		return 0;
+	}
+
+	static void set_edge(std::vector<std::pair<uint8_t, uint32_t>>& edges, uint8_t byte, uint32_t next)
+	{
+		for (auto& [edge_byte, edge_next] : edges)
+		{
+			if (edge_byte == byte)
+			{
+				edge_next = next;
+				return;
+			}
+		}
+
+		edges.emplace_back(byte, next);
+	}
+
+	void substring_index::edge_table::assign(const edges_t& edges)
+	{
+		size_t edge_count = 0;
+		for (const auto& state_edges : edges)
+		{
+			edge_count += state_edges.size();
+		}
+
+		// Keep the load factor under one half.
+		const auto capacity = std::bit_ceil(std::max<size_t>(edge_count * 2, 16));
+		m_keys.assign(capacity, 0);
+		m_values.assign(capacity, 0);
+		m_mask = capacity - 1;
+
+		for (uint32_t state = 0; state < edges.size(); state++)
+		{
+			for (const auto& [byte, next] : edges[state])
+			{
+				const auto key = make_key(state, byte);
+				auto slot      = hash(key);
+				while (m_keys[slot])
+				{
+					slot = (slot + 1) & m_mask;
+				}
+
+				m_keys[slot]   = key;
+				m_values[slot] = next;
+			}
+		}
+	}
+
+	void substring_index::build(std::span<const std::string_view> keys)
+	{
+		build_aho_corasick(keys);
+		build_suffix_automaton(keys);
+	}
+
+	void substring_index::build_aho_corasick(std::span<const std::string_view> keys)
+	{
+		edge_table::edges_t edges(1);
+		m_trie_first_key.assign(1, no_key);
+
+		for (uint32_t key_index = 0; key_index < keys.size(); key_index++)
+		{
+			uint32_t state = 0;
+			for (const auto c : keys[key_index])
+			{
+				auto next = find_edge(edges[state], static_cast<uint8_t>(c));
+				if (!next)
+				{
+					next = static_cast<uint32_t>(edges.size());
+					edges[state].emplace_back(static_cast<uint8_t>(c), next);
+					edges.emplace_back();
+					m_trie_first_key.push_back(no_key);
+				}
+
+				state = next;
+			}
+
+			// An empty key would match everything, that's never what the caller wants.
+			if (state)
+			{
+				m_trie_first_key[state] = std::min(m_trie_first_key[state], key_index);
+			}
+		}
+
+		// Breadth first so that the fail target of a state is always done before the state itself.
+		m_trie_fail.assign(edges.size(), 0);
+		std::vector<uint32_t> queue;
+		queue.reserve(edges.size());
+		for (const auto& [byte, next] : edges[0])
+		{
+			queue.push_back(next);
+		}
+
+		for (size_t i = 0; i < queue.size(); i++)
+		{
+			const auto state = queue[i];
+			m_trie_first_key[state] = std::min(m_trie_first_key[state], m_trie_first_key[m_trie_fail[state]]);
+
+			for (const auto& [byte, next] : edges[state])
+			{
+				auto fail = m_trie_fail[state];
+				while (fail && !find_edge(edges[fail], byte))
+				{
+					fail = m_trie_fail[fail];
+				}
+
+				m_trie_fail[next] = find_edge(edges[fail], byte);
+				queue.push_back(next);
+			}
+		}
+
+		m_trie_edges.assign(edges);
+	}
+
+	void substring_index::build_suffix_automaton(std::span<const std::string_view> keys)
+	{
+		constexpr auto no_link = std::numeric_limits<uint32_t>::max();
+
+		edge_table::edges_t edges(1);
+		std::vector<uint32_t> link{no_link};
+		std::vector<uint32_t> len{0};
+
+		const auto clone_state = [&](uint32_t from, uint32_t new_len)
+		{
+			const auto clone = static_cast<uint32_t>(edges.size());
+			edges.push_back(edges[from]);
+			link.push_back(link[from]);
+			len.push_back(new_len);
+			return clone;
+		};
+
+		// Generalized suffix automaton: every key restarts from the root, existing states are reused instead of duplicated.
+		const auto extend = [&](uint32_t last, uint8_t c) -> uint32_t
+		{
+			if (const auto q = find_edge(edges[last], c))
+			{
+				if (len[last] + 1 == len[q])
+				{
+					return q;
+				}
+
+				const auto clone = clone_state(q, len[last] + 1);
+				for (auto p = last; p != no_link && find_edge(edges[p], c) == q; p = link[p])
+				{
+					set_edge(edges[p], c, clone);
+				}
+				link[q] = clone;
+				return clone;
+			}
+
+			const auto cur = static_cast<uint32_t>(edges.size());
+			edges.emplace_back();
+			link.push_back(0);
+			len.push_back(len[last] + 1);
+
+			auto p = last;
+			while (p != no_link && !find_edge(edges[p], c))
+			{
+				edges[p].emplace_back(c, cur);
+				p = link[p];
+			}
+
+			if (p != no_link)
+			{
+				const auto q = find_edge(edges[p], c);
+				if (len[p] + 1 == len[q])
+				{
+					link[cur] = q;
+				}
+				else
+				{
+					const auto clone = clone_state(q, len[p] + 1);
+					for (; p != no_link && find_edge(edges[p], c) == q; p = link[p])
+					{
+						set_edge(edges[p], c, clone);
+					}
+					link[q]   = clone;
+					link[cur] = clone;
+				}
+			}
+
+			return cur;
+		};
+
+		std::vector<std::pair<uint32_t, uint32_t>> prefix_states;
+		for (uint32_t key_index = 0; key_index < keys.size(); key_index++)
+		{
+			uint32_t last = 0;
+			for (const auto c : keys[key_index])
+			{
+				last = extend(last, static_cast<uint8_t>(c));
+				prefix_states.emplace_back(last, key_index);
+			}
+		}
+
+		// Every prefix state is a key prefix, every substring of a key is a suffix of one of them: push the lowest key index up the suffix links.
+		// Prefix states can be split into clones later on, hence marking them only now.
+		m_sam_first_key.assign(edges.size(), no_key);
+		for (const auto& [state, key_index] : prefix_states)
+		{
+			m_sam_first_key[state] = std::min(m_sam_first_key[state], key_index);
+		}
+
+		std::vector<uint32_t> by_len_desc(edges.size());
+		std::iota(by_len_desc.begin(), by_len_desc.end(), 0);
+		std::ranges::sort(by_len_desc,
+		                  [&](uint32_t a, uint32_t b)
+		                  {
+			                  return len[a] > len[b];
+		                  });
+		for (const auto state : by_len_desc)
+		{
+			if (state && link[state] != no_link)
+			{
+				m_sam_first_key[link[state]] = std::min(m_sam_first_key[link[state]], m_sam_first_key[state]);
+			}
+		}
+
+		m_sam_edges.assign(edges);
+	}
+
+	size_t substring_index::find_key_in(std::string_view text) const
+	{
+		auto best      = no_key;
+		uint32_t state = 0;
+		for (const auto c : text)
+		{
+			const auto byte = static_cast<uint8_t>(c);
+
+			uint32_t next;
+			while (!(next = m_trie_edges.get(state, byte)) && state)
+			{
+				state = m_trie_fail[state];
+			}
+
+			state = next;
+			best  = std::min(best, m_trie_first_key[state]);
+		}
+
+		return best == no_key ? npos : best;
+	}
+
+	size_t substring_index::find_key_containing(std::string_view text) const
+	{
+		if (m_sam_first_key.empty())
+		{
+			return npos;
+		}
+
+		uint32_t state = 0;
+		for (const auto c : text)
+		{
+			state = m_sam_edges.get(state, static_cast<uint8_t>(c));
+			if (!state)
+			{
+				return npos;
+			}
+		}
+
+		const auto res = m_sam_first_key[state];
+		return res == no_key ? npos : res;
+	}
+} // namespace big
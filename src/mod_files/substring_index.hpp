@@ -0,0 +1,85 @@
+#pragma once
+
+#include <span>
+
+namespace big
+{
+	// Fixed set of keys answering, in time linear in the length of a text whatever the number of keys:
+	// - which keys occur inside the text (Aho-Corasick automaton)
+	// - which keys contain the text (generalized suffix automaton)
+	// When multiple keys qualify, the one with the lowest index wins.
+	class substring_index
+	{
+	public:
+		static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+		// The keys don't need to outlive the index.
+		void build(std::span<const std::string_view> keys);
+
+		// Lowest index of the keys that are a substring of text, or npos.
+		size_t find_key_in(std::string_view text) const;
+
+		// Lowest index of the keys that text is a substring of, or npos.
+		size_t find_key_containing(std::string_view text) const;
+
+	private:
+		// (state, byte) -> state, open addressing, filled once at the end of build().
+		// No automaton ever transitions back to its root so 0 doubles as "no edge".
+		class edge_table
+		{
+		public:
+			using edges_t = std::vector<std::vector<std::pair<uint8_t, uint32_t>>>;
+
+			void assign(const edges_t& edges);
+
+			uint32_t get(uint32_t state, uint8_t byte) const
+			{
+				if (m_keys.empty())
+				{
+					return 0;
+				}
+
+				const auto key = make_key(state, byte);
+				for (auto slot = hash(key);; slot = (slot + 1) & m_mask)
+				{
+					if (m_keys[slot] == key)
+					{
+						return m_values[slot];
+					}
+					if (m_keys[slot] == 0)
+					{
+						return 0;
+					}
+				}
+			}
+
+		private:
+			static uint64_t make_key(uint32_t state, uint8_t byte)
+			{
+				// + 1 so that an empty slot (0) never collides with state 0.
+				return ((static_cast<uint64_t>(state) << 8) | byte) + 1;
+			}
+
+			size_t hash(uint64_t key) const
+			{
+				return static_cast<size_t>((key * 0x9E'37'79'B9'7F'4A'7C'15) >> 32) & m_mask;
+			}
+
+			std::vector<uint64_t> m_keys;
+			std::vector<uint32_t> m_values;
+			size_t m_mask = 0;
+		};
+
+		void build_aho_corasick(std::span<const std::string_view> keys);
+		void build_suffix_automaton(std::span<const std::string_view> keys);
+
+		edge_table m_trie_edges;
+		std::vector<uint32_t> m_trie_fail;
+		// Lowest key index ending at the state or at any state of its fail chain.
+		std::vector<uint32_t> m_trie_first_key;
+
+		edge_table m_sam_edges;
+		// Lowest index of the keys containing the substrings the state stands for.
+		std::vector<uint32_t> m_sam_first_key;
+	};
+} // namespace big
@@ -0,0 +1,192 @@
+#include "vfs_overlay.hpp"
+
+#include <unordered_set>
+
+namespace big
+{
+	const plugins_data_manifest::file& vfs_overlay::get_file(const candidate& candidate)
+	{
+		return candidate.m_layer->m_files[candidate.m_file_index];
+	}
+
+	bool vfs_overlay::is_higher_priority(const candidate& left, const candidate& right)
+	{
+		return std::tie(left.m_layer->m_priority, left.m_layer->m_name, left.m_file_index)
+		     < std::tie(right.m_layer->m_priority, right.m_layer->m_name, right.m_file_index);
+	}
+
+	vfs_overlay::mount_stats vfs_overlay::mount(std::vector<layer> layers)
+	{
+		std::unique_lock l(m_mutex);
+
+		mount_stats stats;
+		std::unordered_set<std::string> touched_filenames;
+
+		const auto remove_candidates = [&](const layer* old_layer)
+		{
+			for (const auto& file : old_layer->m_files)
+			{
+				auto& candidates = m_files[file.m_filename];
+				std::erase_if(candidates,
+				              [old_layer](const candidate& candidate)
+				              {
+					              return candidate.m_layer == old_layer;
+				              });
+				touched_filenames.insert(file.m_filename);
+			}
+		};
+
+		// Layers that are gone.
+		for (auto it = m_layers.begin(); it != m_layers.end();)
+		{
+			if (std::ranges::find(layers, it->first, &layer::m_name) == layers.end())
+			{
+				remove_candidates(it->second.get());
+				it = m_layers.erase(it);
+				stats.m_changed_layer_count++;
+			}
+			else
+			{
+				it++;
+			}
+		}
+
+		// Layers that are new or changed.
+		for (auto& new_layer : layers)
+		{
+			auto& mounted_layer = m_layers[new_layer.m_name];
+			if (mounted_layer && mounted_layer->m_priority == new_layer.m_priority && mounted_layer->m_files == new_layer.m_files)
+			{
+				continue;
+			}
+
+			if (mounted_layer)
+			{
+				remove_candidates(mounted_layer.get());
+			}
+
+			mounted_layer = std::make_unique<layer>(std::move(new_layer));
+			for (uint32_t i = 0; i < mounted_layer->m_files.size(); i++)
+			{
+				const auto& filename = mounted_layer->m_files[i].m_filename;
+				m_files[filename].emplace_back(mounted_layer.get(), i);
+				touched_filenames.insert(filename);
+			}
+
+			stats.m_changed_layer_count++;
+		}
+
+		for (const auto& filename : touched_filenames)
+		{
+			const auto it = m_files.find(filename);
+			if (it->second.empty())
+			{
+				m_files.erase(it);
+			}
+			else
+			{
+				std::ranges::sort(it->second, is_higher_priority);
+			}
+		}
+		stats.m_touched_file_count = touched_filenames.size();
+
+		if (stats.m_changed_layer_count)
+		{
+			rebuild_fallback_index();
+		}
+
+		return stats;
+	}
+
+	void vfs_overlay::rebuild_fallback_index()
+	{
+		std::vector<candidate> winners;
+		winners.reserve(m_files.size());
+		for (const auto& [filename, candidates] : m_files)
+		{
+			winners.push_back(candidates.front());
+		}
+
+		// file_redirect_index favors the first file added.
+		std::ranges::sort(winners, is_higher_priority);
+
+		m_fallback_index = {};
+		for (const auto& winner : winners)
+		{
+			const auto& file = get_file(winner);
+			if (file.m_kind == plugins_data_manifest::file_kind::package)
+			{
+				m_fallback_index.add_package(file.m_filename, file.m_full_file_path);
+			}
+			else
+			{
+				m_fallback_index.add_granny(file.m_filename, file.m_full_file_path);
+			}
+		}
+		m_fallback_index.build();
+	}
+
+	std::optional<std::string> vfs_overlay::resolve(std::string_view path_component) const
+	{
+		const auto last_separator = path_component.find_last_of("/\\");
+		const auto filename       = last_separator == std::string_view::npos ? path_component : path_component.substr(last_separator + 1);
+
+		std::shared_lock l(m_mutex);
+
+		if (filename.size())
+		{
+			const auto it = m_files.find(filename);
+			if (it != m_files.end())
+			{
+				return get_file(it->second.front()).m_full_file_path;
+			}
+		}
+
+		if (const auto full_file_path = m_fallback_index.find(path_component))
+		{
+			return *full_file_path;
+		}
+
+		return std::nullopt;
+	}
+
+	std::vector<std::string> vfs_overlay::get_filenames(plugins_data_manifest::file_kind kind) const
+	{
+		std::shared_lock l(m_mutex);
+
+		std::vector<std::string> res;
+		for (const auto& [filename, candidates] : m_files)
+		{
+			if (get_file(candidates.front()).m_kind == kind)
+			{
+				res.push_back(filename);
+			}
+		}
+
+		return res;
+	}
+
+	std::vector<vfs_overlay::conflict> vfs_overlay::get_conflicts() const
+	{
+		std::shared_lock l(m_mutex);
+
+		std::vector<conflict> res;
+		for (const auto& [filename, candidates] : m_files)
+		{
+			if (candidates.size() < 2)
+			{
+				continue;
+			}
+
+			auto& new_conflict          = res.emplace_back();
+			new_conflict.m_filename     = filename;
+			new_conflict.m_winner_layer = candidates.front().m_layer->m_name;
+			for (size_t i = 1; i < candidates.size(); i++)
+			{
+				new_conflict.m_shadowed_layers.push_back(candidates[i].m_layer->m_name);
+			}
+		}
+
+		return res;
+	}
+} // namespace big
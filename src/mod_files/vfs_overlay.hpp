@@ -0,0 +1,83 @@
+#pragma once
+
+#include "file_redirect_index.hpp"
+#include "plugins_data_manifest.hpp"
+
+#include <shared_mutex>
+
+namespace big
+{
+	// Mod files layered over the game asset namespace.
+	// Each mod folder of plugins_data is mounted as a layer, when multiple layers provide the same file name the lowest priority wins
+	// and the others are recorded as shadowed. The file name → physical path table is resolved at mount time,
+	// so that a lookup from the engine path hooks is a single hash probe.
+	class vfs_overlay
+	{
+	public:
+		struct layer
+		{
+			std::string m_name;
+			int32_t m_priority = 0;
+			std::vector<plugins_data_manifest::file> m_files;
+		};
+
+		struct conflict
+		{
+			std::string m_filename;
+			std::string m_winner_layer;
+			std::vector<std::string> m_shadowed_layers;
+		};
+
+		struct mount_stats
+		{
+			size_t m_changed_layer_count = 0;
+			size_t m_touched_file_count  = 0;
+		};
+
+		// Replaces the mount table with the given layers.
+		// Only the files of the layers that got added, removed or changed since the previous call are resolved again.
+		mount_stats mount(std::vector<layer> layers);
+
+		// path_component is what the game handed to fsAppendPathComponent.
+		// Its file name (everything after the last path separator) is looked up first, the older substring matching of file_redirect_index is only a fallback for the
+		// mods relying on it.
+		std::optional<std::string> resolve(std::string_view path_component) const;
+
+		// Winning file names of the given kind.
+		std::vector<std::string> get_filenames(plugins_data_manifest::file_kind kind) const;
+
+		std::vector<conflict> get_conflicts() const;
+
+	private:
+		struct candidate
+		{
+			const layer* m_layer;
+			// Position of the file inside its layer, breaks ties between two files of a same layer.
+			uint32_t m_file_index;
+		};
+
+		struct string_hash
+		{
+			using is_transparent = void;
+
+			size_t operator()(std::string_view str) const
+			{
+				return std::hash<std::string_view>{}(str);
+			}
+		};
+
+		// Sorted, the front one wins.
+		using candidate_list = std::vector<candidate>;
+
+		static const plugins_data_manifest::file& get_file(const candidate& candidate);
+		static bool is_higher_priority(const candidate& left, const candidate& right);
+
+		void rebuild_fallback_index();
+
+		mutable std::shared_mutex m_mutex;
+		// Keyed by layer name, node based so that candidates can point into it.
+		std::unordered_map<std::string, std::unique_ptr<layer>> m_layers;
+		std::unordered_map<std::string, candidate_list, string_hash, std::equal_to<>> m_files;
+		file_redirect_index m_fallback_index;
+	};
+} // namespace big
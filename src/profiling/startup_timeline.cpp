@@ -0,0 +1,128 @@
+#include "startup_timeline.hpp"
+
+namespace big::startup_timeline
+{
+	struct span_event
+	{
+		std::string_view m_category;
+		std::string m_name;
+		DWORD m_thread_id;
+		int64_t m_start_us;
+		int64_t m_duration_us;
+	};
+
+	static std::atomic_bool g_is_recording{true};
+	static std::mutex g_events_mutex;
+	static std::vector<span_event> g_events;
+	static std::vector<std::pair<DWORD, std::string>> g_thread_names;
+
+	// Timestamps are relative to the first recorded span, which happens from DllMain.
+	static std::chrono::steady_clock::time_point get_origin()
+	{
+		static const auto origin = std::chrono::steady_clock::now();
+		return origin;
+	}
+
+	static int64_t to_us(std::chrono::steady_clock::duration duration)
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+	}
+
+	scoped_span::scoped_span(std::string_view category, std::string_view name) :
+	    m_category(category),
+	    m_is_recording(g_is_recording)
+	{
+		if (m_is_recording)
+		{
+			get_origin();
+
+			m_name  = name;
+			m_start = std::chrono::steady_clock::now();
+		}
+	}
+
+	scoped_span::~scoped_span()
+	{
+		if (!m_is_recording)
+		{
+			return;
+		}
+
+		const auto end = std::chrono::steady_clock::now();
+
+		std::scoped_lock l(g_events_mutex);
+		if (g_is_recording)
+		{
+			g_events.emplace_back(m_category, std::move(m_name), GetCurrentThreadId(), to_us(m_start - get_origin()), to_us(end - m_start));
+		}
+	}
+
+	void set_thread_name(std::string_view name)
+	{
+		std::scoped_lock l(g_events_mutex);
+		if (g_is_recording)
+		{
+			g_thread_names.emplace_back(GetCurrentThreadId(), name);
+		}
+	}
+
+	void finish(const std::filesystem::path& trace_file_path)
+	{
+		std::vector<span_event> events;
+		std::vector<std::pair<DWORD, std::string>> thread_names;
+		{
+			std::scoped_lock l(g_events_mutex);
+			if (!g_is_recording)
+			{
+				return;
+			}
+
+			g_is_recording = false;
+			events         = std::move(g_events);
+			thread_names   = std::move(g_thread_names);
+		}
+
+		const auto process_id = GetCurrentProcessId();
+
+		auto trace_events = nlohmann::json::array();
+		for (const auto& [thread_id, name] : thread_names)
+		{
+			trace_events.push_back({
+			    {"name", "thread_name"},
+			    {"ph", "M"},
+			    {"pid", process_id},
+			    {"tid", thread_id},
+			    {"args", {{"name", name}}},
+			});
+		}
+
+		for (const auto& e : events)
+		{
+			trace_events.push_back({
+			    {"name", e.m_name},
+			    {"cat", std::string(e.m_category)},
+			    {"ph", "X"},
+			    {"ts", e.m_start_us},
+			    {"dur", e.m_duration_us},
+			    {"pid", process_id},
+			    {"tid", e.m_thread_id},
+			});
+		}
+
+		const nlohmann::json trace = {
+		    {"traceEvents", std::move(trace_events)},
+		    {"displayTimeUnit", "ms"},
+		};
+
+		std::ofstream file(trace_file_path, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			LOG(WARNING) << "Startup timeline: failed to open " << (char*)trace_file_path.u8string().c_str();
+			return;
+		}
+
+		file << trace.dump();
+
+		LOG(INFO) << "Startup timeline: " << events.size() << " spans written to " << (char*)trace_file_path.u8string().c_str();
+	}
+} // namespace big::startup_timeline
@@ -0,0 +1,30 @@
+#pragma once
+
+namespace big::startup_timeline
+{
+	// Times a scope of the startup: init phases, signature scans, hook creations...
+	// Spans can be recorded from any thread, including from DllMain, and are no-ops once finish() ran.
+	class scoped_span
+	{
+	public:
+		// category is expected to be a string literal.
+		scoped_span(std::string_view category, std::string_view name);
+		~scoped_span();
+
+		scoped_span(const scoped_span&)            = delete;
+		scoped_span& operator=(const scoped_span&) = delete;
+
+	private:
+		std::string_view m_category;
+		std::string m_name;
+		std::chrono::steady_clock::time_point m_start;
+		bool m_is_recording;
+	};
+
+	// Label for the calling thread in the trace viewer.
+	void set_thread_name(std::string_view name);
+
+	// Writes every span recorded so far as a Chrome trace (open it in chrome://tracing or ui.perfetto.dev) and stops recording.
+	// Only the first call does anything.
+	void finish(const std::filesystem::path& trace_file_path);
+} // namespace big::startup_timeline
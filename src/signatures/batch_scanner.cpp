@@ -0,0 +1,213 @@
+#include "batch_scanner.hpp"
+
+#include "simd_kernel.hpp"
+
+namespace big::signatures
+{
+	size_t batch_scanner::add(std::string_view name, const ida_pattern& pattern)
+	{
+		auto& e     = m_entries.emplace_back();
+		e.m_name    = name;
+		e.m_pattern = pattern;
+
+		return m_entries.size() - 1;
+	}
+
+	std::vector<uint32_t> batch_scanner::get_unresolved_entries() const
+	{
+		std::vector<uint32_t> res;
+		for (uint32_t i = 0; i < m_entries.size(); i++)
+		{
+			if (!m_entries[i].m_result)
+			{
+				res.push_back(i);
+			}
+		}
+
+		return res;
+	}
+
+	void batch_scanner::scan_range(const uint8_t* begin, size_t size, size_t match_start_limit, std::span<const uint32_t> entry_indices, std::span<size_t> first_matches) const
+	{
+		const auto get_anchor_byte = [this](uint32_t entry_index)
+		{
+			const auto& e = m_entries[entry_index];
+			return e.m_pattern.m_bytes[e.m_pattern.m_anchor_index];
+		};
+
+		// Bucket the entries by anchor byte value, flattened so that the hot loop stays in a few cache lines.
+		std::array<uint32_t, 257> bucket_begin{};
+		for (const auto entry_index : entry_indices)
+		{
+			bucket_begin[get_anchor_byte(entry_index) + 1]++;
+		}
+		for (size_t i = 1; i < bucket_begin.size(); i++)
+		{
+			bucket_begin[i] += bucket_begin[i - 1];
+		}
+
+		std::vector<uint32_t> buckets(entry_indices.size());
+		auto bucket_cursor = bucket_begin;
+		for (uint32_t i = 0; i < entry_indices.size(); i++)
+		{
+			buckets[bucket_cursor[get_anchor_byte(entry_indices[i])]++] = i;
+		}
+
+		std::vector<uint8_t> needles;
+		for (size_t byte = 0; byte < 256; byte++)
+		{
+			if (bucket_begin[byte] != bucket_begin[byte + 1])
+			{
+				needles.push_back(static_cast<uint8_t>(byte));
+			}
+		}
+
+		size_t remaining = entry_indices.size();
+		if (!remaining)
+		{
+			return;
+		}
+
+		for_each_candidate(get_simd_level(),
+		                   begin,
+		                   size,
+		                   needles,
+		                   [&](size_t pos)
+		                   {
+			                   const auto byte = begin[pos];
+			                   for (auto k = bucket_begin[byte]; k < bucket_begin[byte + 1]; k++)
+			                   {
+				                   const auto i  = buckets[k];
+				                   const auto& e = m_entries[entry_indices[i]];
+				                   if (first_matches[i] != npos || pos < e.m_pattern.m_anchor_index)
+				                   {
+					                   continue;
+				                   }
+
+				                   const auto start = pos - e.m_pattern.m_anchor_index;
+				                   if (start >= match_start_limit || start + e.m_pattern.size() > size)
+				                   {
+					                   continue;
+				                   }
+
+				                   if (e.m_pattern.matches(begin + start))
+				                   {
+					                   first_matches[i] = start;
+					                   remaining--;
+				                   }
+			                   }
+
+			                   return remaining != 0;
+		                   });
+	}
+
+	void batch_scanner::run(const uint8_t* begin, size_t size)
+	{
+		const auto entry_indices = get_unresolved_entries();
+
+		std::vector<size_t> first_matches(entry_indices.size(), npos);
+		scan_range(begin, size, size, entry_indices, first_matches);
+
+		for (size_t i = 0; i < entry_indices.size(); i++)
+		{
+			if (first_matches[i] != npos)
+			{
+				m_entries[entry_indices[i]].m_result = begin + first_matches[i];
+			}
+		}
+	}
+
+	void batch_scanner::run_parallel(const uint8_t* begin, size_t size, size_t worker_count, const spawn_worker_t& spawn_worker)
+	{
+		constexpr size_t chunk_size = 1024 * 1024;
+
+		if (worker_count <= 1 || size <= chunk_size)
+		{
+			run(begin, size);
+			return;
+		}
+
+		const auto entry_indices = get_unresolved_entries();
+		if (entry_indices.empty())
+		{
+			return;
+		}
+
+		size_t longest_pattern_size = 0;
+		for (const auto entry_index : entry_indices)
+		{
+			longest_pattern_size = std::max(longest_pattern_size, m_entries[entry_index].m_pattern.size());
+		}
+
+		const auto chunk_count = (size + chunk_size - 1) / chunk_size;
+		std::vector<std::atomic<size_t>> best_matches(entry_indices.size());
+		for (auto& best_match : best_matches)
+		{
+			best_match = npos;
+		}
+
+		run_parallel_jobs(chunk_count,
+		                  worker_count,
+		                  spawn_worker,
+		                  [&](size_t chunk)
+		                  {
+			                  const auto chunk_begin = chunk * chunk_size;
+			                  const auto chunk_end   = std::min(chunk_begin + chunk_size, size);
+
+			                  // Patterns already found in an earlier chunk can't get a better match here.
+			                  std::vector<uint32_t> needed_entries;
+			                  std::vector<size_t> needed_to_entry;
+			                  for (size_t i = 0; i < entry_indices.size(); i++)
+			                  {
+				                  if (best_matches[i].load(std::memory_order_relaxed) > chunk_begin)
+				                  {
+					                  needed_entries.push_back(entry_indices[i]);
+					                  needed_to_entry.push_back(i);
+				                  }
+			                  }
+
+			                  if (needed_entries.empty())
+			                  {
+				                  return;
+			                  }
+
+			                  const auto scan_end = std::min(chunk_end + longest_pattern_size - 1, size);
+
+			                  std::vector<size_t> first_matches(needed_entries.size(), npos);
+			                  scan_range(begin + chunk_begin, scan_end - chunk_begin, chunk_end - chunk_begin, needed_entries, first_matches);
+
+			                  for (size_t i = 0; i < needed_entries.size(); i++)
+			                  {
+				                  if (first_matches[i] == npos)
+				                  {
+					                  continue;
+				                  }
+
+				                  auto& best           = best_matches[needed_to_entry[i]];
+				                  const auto candidate = chunk_begin + first_matches[i];
+				                  auto current         = best.load();
+				                  while (candidate < current && !best.compare_exchange_weak(current, candidate))
+				                  {
+				                  }
+			                  }
+		                  });
+
+		for (size_t i = 0; i < entry_indices.size(); i++)
+		{
+			const auto first_match = best_matches[i].load();
+			if (first_match != npos)
+			{
+				m_entries[entry_indices[i]].m_result = begin + first_match;
+			}
+		}
+	}
+
+	size_t batch_scanner::found_count() const
+	{
+		return std::ranges::count_if(m_entries,
+		                             [](const entry& e)
+		                             {
+			                             return e.m_result != nullptr;
+		                             });
+	}
+} // namespace big::signatures
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "ida_pattern.hpp"
+
+#include <span>
+#include <threads/parallel_jobs.hpp>
+
+namespace big::signatures
+{
+	// Resolves any number of patterns in a single pass over a memory range.
+	// Each pattern is anchored on its rarest fixed byte, the SIMD kernel finds the positions holding any of the anchor bytes
+	// and only those get looked up in a 256 entries table to know which patterns could start there.
+	class batch_scanner
+	{
+	public:
+		// Returns the index to pass to get() once the batch ran.
+		size_t add(std::string_view name, const ida_pattern& pattern);
+
+		// Can be called multiple times on increasing memory ranges (e.g. one call per code section),
+		// patterns already resolved by a previous call are skipped.
+		// Every pattern keeps its first match, same as scanning the range once per pattern would.
+		void run(const uint8_t* begin, size_t size);
+
+		// Same results as run(), with the range split in chunks that overlap by the longest pattern length minus one.
+		// Workers pull the next chunk from a shared counter until there is none left, so a worker that is done early
+		// takes over what would have been someone else's share. The earliest match of each pattern across chunks wins.
+		// spawn_worker is called worker_count - 1 times with a function to run on another thread, the calling thread works too.
+		// Must not be called while holding the loader lock, the calling thread waits for the other workers.
+		void run_parallel(const uint8_t* begin, size_t size, size_t worker_count, const spawn_worker_t& spawn_worker);
+
+		const uint8_t* get(size_t index) const
+		{
+			return m_entries[index].m_result;
+		}
+
+		std::string_view name(size_t index) const
+		{
+			return m_entries[index].m_name;
+		}
+
+		size_t size() const
+		{
+			return m_entries.size();
+		}
+
+		size_t found_count() const;
+
+	private:
+		static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+		// Scans [begin, begin + size) for the given entries, only accepting matches that start before match_start_limit.
+		// first_matches[i] receives the offset of the first match of entry_indices[i], or npos.
+		void scan_range(const uint8_t* begin, size_t size, size_t match_start_limit, std::span<const uint32_t> entry_indices, std::span<size_t> first_matches) const;
+
+		std::vector<uint32_t> get_unresolved_entries() const;
+
+		struct entry
+		{
+			std::string m_name;
+			ida_pattern m_pattern;
+			const uint8_t* m_result = nullptr;
+		};
+
+		std::vector<entry> m_entries;
+	};
+} // namespace big::signatures
@@ -0,0 +1,71 @@
+#pragma once
+
+namespace big::signatures
+{
+	// Coarse estimate of how often each byte value shows up in MSVC x64 code (higher is more common).
+	// Used to anchor patterns on their rarest fixed byte so that the scanners verify as few candidates as possible.
+	inline constexpr std::array<uint8_t, 256> x64_byte_frequency = []()
+	{
+		std::array<uint8_t, 256> res{};
+		res.fill(10);
+
+		// clang-format off
+		constexpr std::pair<uint8_t, uint8_t> common_bytes[] = {
+			{0x00, 255}, {0x48, 200}, {0x8B, 190}, {0xFF, 160}, {0x89, 150}, {0x24, 140}, {0x4C, 120}, {0x0F, 120},
+			{0x44, 110}, {0x8D, 110}, {0xCC, 110}, {0xE8, 100}, {0x85, 90},  {0xC0, 90},  {0x01, 90},  {0x74, 80},
+			{0x83, 80},  {0x49, 80},  {0x45, 70},  {0x41, 70},  {0x08, 70},  {0x20, 70},  {0x40, 70},  {0x4D, 60},
+			{0x10, 60},  {0x28, 60},  {0x30, 55},  {0x38, 50},  {0x18, 50},  {0xC3, 50},  {0x33, 50},  {0xC7, 50},
+			{0x75, 50},  {0xEB, 50},  {0x84, 50},  {0x05, 50},  {0x02, 50},  {0x04, 50},  {0x50, 45},  {0x15, 45},
+			{0x03, 45},  {0x60, 40},  {0x70, 40},  {0x80, 40},  {0x0D, 40},  {0xE9, 40},  {0x5C, 40},  {0x54, 40},
+			{0x3B, 40},  {0x90, 40},  {0xC1, 40},  {0x88, 40},  {0xC4, 40},  {0xC8, 40},  {0x0C, 35},  {0x4E, 30},
+			{0x63, 30},  {0x7C, 30},  {0xC6, 30},  {0xD0, 30},  {0xD8, 30},  {0xF0, 30},  {0xF8, 30},  {0xB8, 30},
+			{0x8A, 30},  {0x14, 30},  {0x1C, 30},  {0x2C, 30},  {0x34, 30},  {0x3C, 30},  {0x5B, 30},  {0x5E, 30},
+			{0x5F, 30},  {0xC9, 30},  {0xD2, 30},  {0xDB, 30},  {0xE0, 30},  {0xF6, 30},  {0x06, 30},  {0x07, 25},
+			{0x09, 25},  {0x0B, 25},  {0x0E, 25},
+		};
+		// clang-format on
+
+		for (const auto& [byte, frequency] : common_bytes)
+		{
+			res[byte] = frequency;
+		}
+
+		return res;
+	}();
+
+	// Indices of the two least common fixed bytes of a pattern, rarest first, or nullopt when it only has wildcards.
+	// Both indices are the same when the pattern only has one fixed byte.
+	template<size_t N>
+	constexpr std::optional<std::pair<size_t, size_t>> get_rarest_byte_indices(const std::array<uint8_t, N>& bytes, const std::array<uint8_t, N>& mask, size_t size)
+	{
+		constexpr auto npos = std::numeric_limits<size_t>::max();
+
+		size_t rarest = npos;
+		size_t second = npos;
+		for (size_t i = 0; i < size; i++)
+		{
+			if (!mask[i])
+			{
+				continue;
+			}
+
+			const auto frequency = x64_byte_frequency[bytes[i]];
+			if (rarest == npos || frequency < x64_byte_frequency[bytes[rarest]])
+			{
+				second = rarest;
+				rarest = i;
+			}
+			else if (second == npos || frequency < x64_byte_frequency[bytes[second]])
+			{
+				second = i;
+			}
+		}
+
+		if (rarest == npos)
+		{
+			return std::nullopt;
+		}
+
+		return std::pair{rarest, second == npos ? rarest : second};
+	}
+} // namespace big::signatures
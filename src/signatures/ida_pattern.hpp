@@ -0,0 +1,166 @@
+#pragma once
+
+#include "byte_frequency.hpp"
+
+namespace big::signatures
+{
+	// IDA style signature ("E8 ? ? ? ? 90 48 8B") split into the byte values and a mask.
+	// A mask byte of 0xFF means the byte must match, 0x00 means it's a wildcard.
+	// Built at compile time from a string literal: a malformed pattern fails the build and nothing gets parsed or allocated at launch.
+	struct ida_pattern
+	{
+		static constexpr size_t max_size = 32;
+
+		// Text the pattern was built from, used as its key by the startup batch and the signatures cache.
+		std::string_view m_ida;
+
+		std::array<uint8_t, max_size> m_bytes{};
+		std::array<uint8_t, max_size> m_mask{};
+		size_t m_size = 0;
+
+		// The two least common fixed bytes of the pattern (rarest first), what the SIMD scanners look for.
+		size_t m_anchor_index        = 0;
+		size_t m_second_anchor_index = 0;
+
+		// Horspool shift for each byte value found under the last byte of the pattern, used by the scalar scanner.
+		std::array<uint8_t, 256> m_skip{};
+
+		constexpr ida_pattern() = default;
+
+		consteval ida_pattern(const char* ida_signature)
+		{
+			const auto res = parse(ida_signature);
+			if (!res)
+			{
+				throw "Malformed IDA pattern: only hex bytes and ? / ?? wildcards, at least one fixed byte, up to max_size bytes.";
+			}
+
+			*this = *res;
+		}
+
+		static constexpr std::optional<ida_pattern> parse(std::string_view ida_signature)
+		{
+			ida_pattern res;
+			res.m_ida = ida_signature;
+
+			size_t i = 0;
+			while (i < ida_signature.size())
+			{
+				if (ida_signature[i] == ' ')
+				{
+					i++;
+					continue;
+				}
+
+				if (res.m_size == max_size)
+				{
+					return std::nullopt;
+				}
+
+				if (ida_signature[i] == '?')
+				{
+					// Both "?" and "??" are accepted as a single wildcard byte.
+					i++;
+					if (i < ida_signature.size() && ida_signature[i] == '?')
+					{
+						i++;
+					}
+
+					res.m_bytes[res.m_size] = 0;
+					res.m_mask[res.m_size]  = 0;
+					res.m_size++;
+					continue;
+				}
+
+				if (i + 1 >= ida_signature.size())
+				{
+					return std::nullopt;
+				}
+
+				const auto high = hex_char_to_int(ida_signature[i]);
+				const auto low  = hex_char_to_int(ida_signature[i + 1]);
+				if (high < 0 || low < 0)
+				{
+					return std::nullopt;
+				}
+
+				res.m_bytes[res.m_size] = static_cast<uint8_t>((high << 4) | low);
+				res.m_mask[res.m_size]  = 0xFF;
+				res.m_size++;
+				i += 2;
+			}
+
+			// A pattern made only of wildcards would match everywhere.
+			const auto anchors = get_rarest_byte_indices(res.m_bytes, res.m_mask, res.m_size);
+			if (!anchors)
+			{
+				return std::nullopt;
+			}
+
+			res.m_anchor_index        = anchors->first;
+			res.m_second_anchor_index = anchors->second;
+			res.compute_skip_table();
+
+			return res;
+		}
+
+		constexpr size_t size() const
+		{
+			return m_size;
+		}
+
+		bool matches(const uint8_t* data) const
+		{
+			for (size_t i = 0; i < m_size; i++)
+			{
+				if ((data[i] & m_mask[i]) != m_bytes[i])
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+	private:
+		static constexpr int hex_char_to_int(char c)
+		{
+			if (c >= '0' && c <= '9')
+			{
+				return c - '0';
+			}
+			if (c >= 'a' && c <= 'f')
+			{
+				return c - 'a' + 10;
+			}
+			if (c >= 'A' && c <= 'F')
+			{
+				return c - 'A' + 10;
+			}
+
+			return -1;
+		}
+
+		constexpr void compute_skip_table()
+		{
+			// A wildcard matches any byte, so no shift can jump over the last one.
+			size_t max_shift = m_size;
+			for (size_t i = 0; i + 1 < m_size; i++)
+			{
+				if (!m_mask[i])
+				{
+					max_shift = m_size - 1 - i;
+				}
+			}
+
+			m_skip.fill(static_cast<uint8_t>(max_shift));
+			for (size_t i = 0; i + 1 < m_size; i++)
+			{
+				if (m_mask[i])
+				{
+					m_skip[m_bytes[i]] = static_cast<uint8_t>(std::min(max_shift, m_size - 1 - i));
+				}
+			}
+		}
+	};
+} // namespace big::signatures
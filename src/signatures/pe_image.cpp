@@ -0,0 +1,38 @@
+#include "pe_image.hpp"
+
+namespace big::signatures
+{
+	std::vector<image_section> get_code_sections(const uint8_t* image_base)
+	{
+		std::vector<image_section> res;
+
+		const auto dos_header = reinterpret_cast<const IMAGE_DOS_HEADER*>(image_base);
+		if (dos_header->e_magic != IMAGE_DOS_SIGNATURE)
+		{
+			return res;
+		}
+
+		const auto nt_headers = reinterpret_cast<const IMAGE_NT_HEADERS*>(image_base + dos_header->e_lfanew);
+		if (nt_headers->Signature != IMAGE_NT_SIGNATURE)
+		{
+			return res;
+		}
+
+		auto section = IMAGE_FIRST_SECTION(nt_headers);
+		for (WORD i = 0; i < nt_headers->FileHeader.NumberOfSections; i++, section++)
+		{
+			if (section->Characteristics & IMAGE_SCN_MEM_EXECUTE)
+			{
+				res.emplace_back(image_base + section->VirtualAddress, section->Misc.VirtualSize);
+			}
+		}
+
+		std::ranges::sort(res,
+		                  [](const image_section& a, const image_section& b)
+		                  {
+			                  return a.m_begin < b.m_begin;
+		                  });
+
+		return res;
+	}
+} // namespace big::signatures
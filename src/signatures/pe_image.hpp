@@ -0,0 +1,13 @@
+#pragma once
+
+namespace big::signatures
+{
+	struct image_section
+	{
+		const uint8_t* m_begin;
+		size_t m_size;
+	};
+
+	// Returns the executable sections of a PE image mapped in memory, in address order.
+	std::vector<image_section> get_code_sections(const uint8_t* image_base);
+} // namespace big::signatures
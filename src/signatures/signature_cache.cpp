@@ -0,0 +1,217 @@
+#include "signature_cache.hpp"
+
+#include "pe_image.hpp"
+
+#define XXH_STATIC_LINKING_ONLY
+#include <xxhash.h>
+
+namespace big::signatures
+{
+	// Bump when the layout of the file changes.
+	static constexpr uint32_t cache_format_version = 1;
+	static constexpr uint32_t cache_magic          = 0x43'53'32'48; // "H2SC"
+
+#pragma pack(push, 1)
+
+	struct cache_header
+	{
+		uint32_t m_magic;
+		uint32_t m_format_version;
+		uint64_t m_image_hash;
+		uint32_t m_entry_count;
+	};
+
+	struct cache_entry
+	{
+		uint64_t m_pattern_hash;
+		uint32_t m_offset;
+	};
+
+#pragma pack(pop)
+
+	// Returns the [begin, end) relative virtual addresses of every spot the loader may have patched.
+	static std::vector<std::pair<uint32_t, uint32_t>> get_relocated_ranges(const uint8_t* image_base, const IMAGE_NT_HEADERS* nt_headers)
+	{
+		std::vector<std::pair<uint32_t, uint32_t>> res;
+
+		const auto& reloc_directory = nt_headers->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_BASERELOC];
+		if (!reloc_directory.VirtualAddress || !reloc_directory.Size)
+		{
+			return res;
+		}
+
+		auto block           = reinterpret_cast<const IMAGE_BASE_RELOCATION*>(image_base + reloc_directory.VirtualAddress);
+		const auto block_end = reinterpret_cast<const uint8_t*>(block) + reloc_directory.Size;
+		while (reinterpret_cast<const uint8_t*>(block) + sizeof(IMAGE_BASE_RELOCATION) <= block_end && block->SizeOfBlock >= sizeof(IMAGE_BASE_RELOCATION))
+		{
+			const auto entries     = reinterpret_cast<const WORD*>(block + 1);
+			const auto entry_count = (block->SizeOfBlock - sizeof(IMAGE_BASE_RELOCATION)) / sizeof(WORD);
+			for (size_t i = 0; i < entry_count; i++)
+			{
+				const auto type = entries[i] >> 12;
+				const auto rva  = block->VirtualAddress + (entries[i] & 0xF'FF);
+				if (type == IMAGE_REL_BASED_DIR64)
+				{
+					res.emplace_back(rva, rva + 8);
+				}
+				else if (type == IMAGE_REL_BASED_HIGHLOW)
+				{
+					res.emplace_back(rva, rva + 4);
+				}
+			}
+
+			block = reinterpret_cast<const IMAGE_BASE_RELOCATION*>(reinterpret_cast<const uint8_t*>(block) + block->SizeOfBlock);
+		}
+
+		std::ranges::sort(res);
+
+		return res;
+	}
+
+	uint64_t hash_image(const uint8_t* image_base)
+	{
+		XXH64_state_t hasher;
+		XXH64_reset(&hasher, 0);
+
+		const auto dos_header = reinterpret_cast<const IMAGE_DOS_HEADER*>(image_base);
+		const auto nt_headers = reinterpret_cast<const IMAGE_NT_HEADERS*>(image_base + dos_header->e_lfanew);
+
+		// The loader writes the actual base address into the mapped headers.
+		std::vector<uint8_t> headers(image_base, image_base + nt_headers->OptionalHeader.SizeOfHeaders);
+		const auto image_base_field_offset = reinterpret_cast<const uint8_t*>(&nt_headers->OptionalHeader.ImageBase) - image_base;
+		memset(headers.data() + image_base_field_offset, 0, sizeof(nt_headers->OptionalHeader.ImageBase));
+		XXH64_update(&hasher, headers.data(), headers.size());
+
+		const auto relocated_ranges = get_relocated_ranges(image_base, nt_headers);
+		auto relocated_range_it     = relocated_ranges.begin();
+
+		constexpr size_t page_size = 0x10'00;
+		std::array<uint8_t, page_size> page_copy;
+		for (const auto& section : get_code_sections(image_base))
+		{
+			for (size_t page_offset = 0; page_offset < section.m_size; page_offset += page_size)
+			{
+				const auto page       = section.m_begin + page_offset;
+				const auto chunk_size = std::min(page_size, section.m_size - page_offset);
+				const auto page_rva   = static_cast<uint32_t>(page - image_base);
+				const auto page_end   = static_cast<uint32_t>(page_rva + chunk_size);
+
+				while (relocated_range_it != relocated_ranges.end() && relocated_range_it->second <= page_rva)
+				{
+					relocated_range_it++;
+				}
+
+				if (relocated_range_it == relocated_ranges.end() || relocated_range_it->first >= page_end)
+				{
+					XXH64_update(&hasher, page, chunk_size);
+					continue;
+				}
+
+				memcpy(page_copy.data(), page, chunk_size);
+				for (auto it = relocated_range_it; it != relocated_ranges.end() && it->first < page_end; it++)
+				{
+					const auto begin = std::max(it->first, page_rva) - page_rva;
+					const auto end   = std::min(it->second, page_end) - page_rva;
+					memset(page_copy.data() + begin, 0, end - begin);
+				}
+				XXH64_update(&hasher, page_copy.data(), chunk_size);
+			}
+		}
+
+		return XXH64_digest(&hasher);
+	}
+
+	uint64_t hash_pattern(std::string_view ida_signature)
+	{
+		// FNV-1a
+		uint64_t res = 0xCB'F2'9C'E4'84'22'23'25;
+		for (const auto c : ida_signature)
+		{
+			res ^= static_cast<uint8_t>(c);
+			res *= 0x1'00'00'00'01'B3;
+		}
+
+		return res;
+	}
+
+	signature_cache::signature_cache(std::filesystem::path file_path) :
+	    m_file_path(std::move(file_path))
+	{
+	}
+
+	bool signature_cache::load(uint64_t image_hash)
+	{
+		m_offsets.clear();
+
+		std::ifstream file(m_file_path, std::ios::binary);
+		if (!file.is_open())
+		{
+			return false;
+		}
+
+		cache_header header{};
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!file || header.m_magic != cache_magic || header.m_format_version != cache_format_version || header.m_image_hash != image_hash)
+		{
+			return false;
+		}
+
+		std::vector<cache_entry> entries(header.m_entry_count);
+		file.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(cache_entry));
+		if (!file)
+		{
+			return false;
+		}
+
+		for (const auto& entry : entries)
+		{
+			m_offsets[entry.m_pattern_hash] = entry.m_offset;
+		}
+
+		return true;
+	}
+
+	bool signature_cache::write(uint64_t image_hash) const
+	{
+		std::error_code ec;
+		std::filesystem::create_directories(m_file_path.parent_path(), ec);
+
+		std::ofstream file(m_file_path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			return false;
+		}
+
+		const cache_header header{
+		    .m_magic          = cache_magic,
+		    .m_format_version = cache_format_version,
+		    .m_image_hash     = image_hash,
+		    .m_entry_count    = static_cast<uint32_t>(m_offsets.size()),
+		};
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		for (const auto& [pattern_hash, offset] : m_offsets)
+		{
+			const cache_entry entry{.m_pattern_hash = pattern_hash, .m_offset = offset};
+			file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+		}
+
+		return static_cast<bool>(file);
+	}
+
+	std::optional<uint32_t> signature_cache::get(uint64_t pattern_hash) const
+	{
+		const auto it = m_offsets.find(pattern_hash);
+		if (it != m_offsets.end())
+		{
+			return it->second;
+		}
+
+		return std::nullopt;
+	}
+
+	void signature_cache::set(uint64_t pattern_hash, uint32_t offset)
+	{
+		m_offsets[pattern_hash] = offset;
+	}
+} // namespace big::signatures
@@ -0,0 +1,31 @@
+#pragma once
+
+namespace big::signatures
+{
+	// Hash of the PE headers and the code sections of an image mapped in memory.
+	// Spots patched by base relocations are skipped so that the hash stays the same across launches even with ASLR.
+	// Must be computed before any hook gets written into the code.
+	uint64_t hash_image(const uint8_t* image_base);
+
+	uint64_t hash_pattern(std::string_view ida_signature);
+
+	// Module relative offsets of every resolved signature, saved to disk so that an unchanged game build needs no scanning.
+	class signature_cache
+	{
+	public:
+		static constexpr uint32_t not_found_offset = std::numeric_limits<uint32_t>::max();
+
+		explicit signature_cache(std::filesystem::path file_path);
+
+		// Returns false if the file doesn't exist, is from another format version or from another game build.
+		bool load(uint64_t image_hash);
+		bool write(uint64_t image_hash) const;
+
+		std::optional<uint32_t> get(uint64_t pattern_hash) const;
+		void set(uint64_t pattern_hash, uint32_t offset);
+
+	private:
+		std::filesystem::path m_file_path;
+		std::unordered_map<uint64_t, uint32_t> m_offsets;
+	};
+} // namespace big::signatures
@@ -0,0 +1,329 @@
+#include "signatures.hpp"
+
+#include "batch_scanner.hpp"
+#include "pe_image.hpp"
+#include "signature_cache.hpp"
+#include "simd_kernel.hpp"
+
+#include "profiling/startup_timeline.hpp"
+
+#include <memory/module.hpp>
+#include <threads/thread_pool.hpp>
+
+namespace big::signatures
+{
+	struct startup_batch_result
+	{
+		uintptr_t m_address = 0;
+		bool m_is_deferred  = false;
+	};
+
+	// Every key is inserted from DllMain, only the values of the deferred signatures get written afterwards by run_deferred_batch.
+	static std::unordered_map<std::string_view, startup_batch_result> g_startup_batch_results;
+
+	// Symbol name to its table entry, only written from DllMain.
+	static std::unordered_map<std::string_view, const signature*> g_symbols;
+
+	struct deferred_signature
+	{
+		std::string_view m_name;
+		ida_pattern m_pattern;
+	};
+
+	static std::vector<deferred_signature> g_deferred_signatures;
+	static std::atomic_bool g_deferred_batch_started{false};
+	static std::atomic_bool g_deferred_batch_done{false};
+
+	static std::unique_ptr<signature_cache> g_cache;
+	static uint64_t g_image_hash = 0;
+	static bool g_is_cache_dirty = false;
+
+	static struct startup_batch_report_t
+	{
+		struct stage_t
+		{
+			size_t m_scanned_count = 0;
+			size_t m_scanned_bytes = 0;
+			size_t m_worker_count  = 1;
+			std::chrono::microseconds m_duration{};
+		};
+
+		size_t m_signature_count = 0;
+		size_t m_cached_count    = 0;
+		stage_t m_loader;
+		stage_t m_deferred;
+		std::vector<std::string_view> m_missing_signatures;
+		bool m_cache_write_failed = false;
+	} g_startup_batch_report;
+
+	static std::vector<image_section> get_scan_sections()
+	{
+		const auto mem_region   = memory::module(rom::g_target_module_name);
+		const auto module_begin = mem_region.begin().as<const uint8_t*>();
+
+		auto res = get_code_sections(module_begin);
+		if (res.empty())
+		{
+			res.emplace_back(module_begin, mem_region.size());
+		}
+
+		return res;
+	}
+
+	static void store_batch_results(const batch_scanner& batch, const std::vector<std::pair<size_t, std::string_view>>& batch_index_to_ida, const uint8_t* module_begin)
+	{
+		for (const auto& [batch_index, ida] : batch_index_to_ida)
+		{
+			const auto res = batch.get(batch_index);
+			if (res)
+			{
+				g_startup_batch_results[ida].m_address = reinterpret_cast<uintptr_t>(res);
+				g_cache->set(hash_pattern(ida), static_cast<uint32_t>(res - module_begin));
+			}
+			else
+			{
+				g_startup_batch_report.m_missing_signatures.push_back(batch.name(batch_index));
+				g_cache->set(hash_pattern(ida), signature_cache::not_found_offset);
+			}
+		}
+
+		g_is_cache_dirty = true;
+	}
+
+	void run_startup_batch(std::span<const signature> signatures, const std::filesystem::path& cache_file_path)
+	{
+		startup_timeline::scoped_span span("signatures", "Loader stage batch");
+
+		const auto start_time = std::chrono::high_resolution_clock::now();
+
+		const auto mem_region   = memory::module(rom::g_target_module_name);
+		const auto module_begin = mem_region.begin().as<const uint8_t*>();
+
+		g_image_hash = hash_image(module_begin);
+		g_cache      = std::make_unique<signature_cache>(cache_file_path);
+
+		const bool is_cache_up_to_date = g_cache->load(g_image_hash);
+
+		batch_scanner batch;
+		std::vector<std::pair<size_t, std::string_view>> batch_index_to_ida;
+		for (const auto& sig : signatures)
+		{
+			g_symbols.emplace(sig.m_name, &sig);
+
+			const auto& ida = sig.m_pattern.m_ida;
+			if (g_startup_batch_results.contains(ida))
+			{
+				continue;
+			}
+
+			g_startup_batch_report.m_signature_count++;
+
+			if (is_cache_up_to_date)
+			{
+				const auto cached_offset = g_cache->get(hash_pattern(ida));
+				if (cached_offset)
+				{
+					g_startup_batch_report.m_cached_count++;
+
+					if (*cached_offset == signature_cache::not_found_offset)
+					{
+						g_startup_batch_results[ida] = {};
+						g_startup_batch_report.m_missing_signatures.push_back(sig.m_name);
+					}
+					else
+					{
+						g_startup_batch_results[ida] = {.m_address = reinterpret_cast<uintptr_t>(module_begin) + *cached_offset};
+					}
+
+					continue;
+				}
+			}
+
+			if (sig.m_stage == resolve_stage::deferred)
+			{
+				g_startup_batch_results[ida] = {.m_is_deferred = true};
+				g_deferred_signatures.emplace_back(sig.m_name, sig.m_pattern);
+				continue;
+			}
+
+			g_startup_batch_results[ida] = {};
+			batch_index_to_ida.emplace_back(batch.add(sig.m_name, sig.m_pattern), ida);
+		}
+
+		if (batch.size())
+		{
+			for (const auto& section : get_scan_sections())
+			{
+				batch.run(section.m_begin, section.m_size);
+				g_startup_batch_report.m_loader.m_scanned_bytes += section.m_size;
+			}
+
+			store_batch_results(batch, batch_index_to_ida, module_begin);
+			g_startup_batch_report.m_loader.m_scanned_count = batch.size();
+		}
+
+		g_startup_batch_report.m_loader.m_duration =
+		    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start_time);
+	}
+
+	void run_deferred_batch()
+	{
+		startup_timeline::scoped_span span("signatures", "Deferred stage batch");
+
+		const auto start_time = std::chrono::high_resolution_clock::now();
+
+		g_deferred_batch_started = true;
+
+		if (g_deferred_signatures.size())
+		{
+			const auto mem_region   = memory::module(rom::g_target_module_name);
+			const auto module_begin = mem_region.begin().as<const uint8_t*>();
+
+			batch_scanner batch;
+			std::vector<std::pair<size_t, std::string_view>> batch_index_to_ida;
+			for (auto& sig : g_deferred_signatures)
+			{
+				batch_index_to_ida.emplace_back(batch.add(sig.m_name, sig.m_pattern), sig.m_pattern.m_ida);
+			}
+
+			const auto worker_count = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 16);
+			for (const auto& section : get_scan_sections())
+			{
+				batch.run_parallel(section.m_begin,
+				                   section.m_size,
+				                   worker_count,
+				                   [](std::function<void()> work)
+				                   {
+					                   g_thread_pool->push(
+					                       [work = std::move(work)]
+					                       {
+						                       startup_timeline::scoped_span span("signatures", "Deferred stage batch worker");
+						                       work();
+					                       });
+				                   });
+				g_startup_batch_report.m_deferred.m_scanned_bytes += section.m_size;
+			}
+
+			store_batch_results(batch, batch_index_to_ida, module_begin);
+			g_startup_batch_report.m_deferred.m_scanned_count = batch.size();
+			g_startup_batch_report.m_deferred.m_worker_count  = worker_count;
+
+			g_deferred_signatures.clear();
+		}
+
+		if (g_is_cache_dirty)
+		{
+			g_startup_batch_report.m_cache_write_failed = !g_cache->write(g_image_hash);
+			g_is_cache_dirty                            = false;
+		}
+		g_cache.reset();
+
+		g_deferred_batch_done = true;
+		g_deferred_batch_done.notify_all();
+
+		g_startup_batch_report.m_deferred.m_duration =
+		    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start_time);
+	}
+
+	void log_startup_batch_report()
+	{
+		const auto& report = g_startup_batch_report;
+
+		LOGF(INFO,
+		     "Signatures: resolved {} / {} patterns, {} from the cache.",
+		     report.m_signature_count - report.m_missing_signatures.size(),
+		     report.m_signature_count,
+		     report.m_cached_count);
+
+		const auto log_stage = [](std::string_view stage_name, const startup_batch_report_t::stage_t& stage)
+		{
+			if (!stage.m_scanned_count)
+			{
+				return;
+			}
+
+			const auto seconds = stage.m_duration.count() / 1'000'000.0;
+			LOGF(INFO,
+			     "Signatures: {} stage scanned {} patterns in one pass over {} KB of game code in {} ms ({:.2f} GB/s, {} kernel, {} workers).",
+			     stage_name,
+			     stage.m_scanned_count,
+			     stage.m_scanned_bytes / 1024,
+			     stage.m_duration.count() / 1000.0,
+			     seconds > 0 ? stage.m_scanned_bytes / seconds / 1'000'000'000.0 : 0.0,
+			     get_simd_level_name(get_simd_level()),
+			     stage.m_worker_count);
+		};
+		log_stage("Loader", report.m_loader);
+		log_stage("Deferred", report.m_deferred);
+
+		if (report.m_cache_write_failed)
+		{
+			LOG(WARNING) << "Signatures: failed to write the signatures cache file.";
+		}
+
+		for (const auto& name : report.m_missing_signatures)
+		{
+			LOG(ERROR) << "Signatures: failed to find " << name;
+		}
+	}
+
+	gmAddress get(std::string_view name)
+	{
+		const auto it = g_symbols.find(name);
+		if (it == g_symbols.end())
+		{
+			LOG(ERROR) << "Signatures: unknown symbol " << name;
+			return gmAddress{};
+		}
+
+		const auto& sig = *it->second;
+
+		// Table names are string literals.
+		auto res = scan(sig.m_pattern, sig.m_name.data());
+		if (!res)
+		{
+			return res;
+		}
+
+		res = res.offset(sig.m_offset);
+		switch (sig.m_fixup)
+		{
+		case address_fixup::get_call: return res.get_call();
+		case address_fixup::rip:      return res.rip();
+		default:                      return res;
+		}
+	}
+
+	gmAddress scan(const ida_pattern& pattern, const char* name)
+	{
+		startup_timeline::scoped_span span("signature", name);
+
+		const auto it = g_startup_batch_results.find(pattern.m_ida);
+		if (it != g_startup_batch_results.end())
+		{
+			if (!it->second.m_is_deferred || g_deferred_batch_done)
+			{
+				return gmAddress{it->second.m_address};
+			}
+
+			// Only wait once the main thread is on it, the caller could otherwise be the loader thread.
+			if (g_deferred_batch_started)
+			{
+				g_deferred_batch_done.wait(false);
+				return gmAddress{it->second.m_address};
+			}
+		}
+
+		for (const auto& section : get_scan_sections())
+		{
+			const auto res = find_first(pattern, section.m_begin, section.m_size);
+			if (res)
+			{
+				return gmAddress{reinterpret_cast<uintptr_t>(res)};
+			}
+		}
+
+		LOG(ERROR) << "Signatures: failed to find " << name;
+		return gmAddress{};
+	}
+} // namespace big::signatures
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ida_pattern.hpp"
+
+#include <memory/gm_address.hpp>
+#include <span>
+
+namespace big::signatures
+{
+	enum class resolve_stage : uint8_t
+	{
+		// Needed from DllMain. Scanned on the loader thread: no other thread can start while the loader lock is held.
+		loader,
+		// Scanned on the thread pool by run_deferred_batch once the main thread is up.
+		deferred,
+	};
+
+	// Applied to the match address, after m_offset, to get to the symbol address.
+	enum class address_fixup : uint8_t
+	{
+		none,
+		// The address holds a call instruction, follow it.
+		get_call,
+		// The address holds a rip relative displacement, follow it.
+		rip,
+	};
+
+	// A game symbol: its pattern and how to get from the match to the symbol itself.
+	struct signature
+	{
+		std::string_view m_name;
+		ida_pattern m_pattern;
+		resolve_stage m_stage = resolve_stage::loader;
+		int32_t m_offset      = 0;
+		address_fixup m_fixup = address_fixup::none;
+	};
+
+	// Resolves the loader stage signatures in a single pass over the code sections of the target module.
+	// Results are saved as module relative offsets to the cache file, keyed by a hash of the game binary,
+	// so that launching the same game build again doesn't scan anything, whatever the stage.
+	// Meant to be called once from DllMain, before any signatures::scan call and before any hook is written.
+	// The table is referenced afterwards by signatures::get, it must be a static one.
+	void run_startup_batch(std::span<const signature> signatures, const std::filesystem::path& cache_file_path);
+
+	// Resolves the deferred stage signatures that were not in the cache, in parallel on the thread pool, and updates the cache file.
+	// signatures::scan calls for those signatures made from other threads in the meantime wait for it.
+	void run_deferred_batch();
+
+	// The startup batch runs before the logger exists, this outputs what happened during both stages.
+	void log_startup_batch_report();
+
+	// Address of a symbol from the run_startup_batch table, with its offset and fixup applied. Empty when it wasn't found.
+	// Same as signatures::scan, waits for the deferred batch when needed.
+	gmAddress get(std::string_view name);
+
+	// Typed handle to a symbol of the run_startup_batch table, T being the function or variable type.
+	template<typename T = void>
+	struct symbol
+	{
+		std::string_view m_name;
+
+		gmAddress address() const
+		{
+			return signatures::get(m_name);
+		}
+
+		T* get() const
+		{
+			return address().template as<T*>();
+		}
+	};
+
+	// Drop-in replacement for gmAddress::scan, served from the startup batch results.
+	// Patterns that are not part of the batch are scanned on their own with the SIMD kernel.
+	// The pattern literal is compiled at build time, see ida_pattern.
+	gmAddress scan(const ida_pattern& pattern, const char* name = "");
+} // namespace big::signatures
@@ -0,0 +1,146 @@
+#include "simd_kernel.hpp"
+
+#include <intrin.h>
+
+namespace big::signatures
+{
+	static simd_level detect_simd_level()
+	{
+		int cpu_info[4]{};
+		__cpuid(cpu_info, 0);
+		const auto max_leaf = cpu_info[0];
+
+		__cpuid(cpu_info, 1);
+		const bool has_osxsave = cpu_info[2] & (1 << 27);
+		const bool has_avx     = cpu_info[2] & (1 << 28);
+
+		bool has_avx2 = false;
+		if (max_leaf >= 7)
+		{
+			__cpuidex(cpu_info, 7, 0);
+			has_avx2 = cpu_info[1] & (1 << 5);
+		}
+
+		// The OS must also save the xmm and ymm registers on context switches.
+		const bool os_saves_ymm = has_osxsave && (_xgetbv(0) & 0b110) == 0b110;
+
+		if (has_avx && has_avx2 && os_saves_ymm)
+		{
+			return simd_level::avx2;
+		}
+
+#if defined(_M_X64)
+		// Part of the x64 baseline, the 16 bytes kernels need nothing newer.
+		return simd_level::sse2;
+#else
+		return simd_level::scalar;
+#endif
+	}
+
+	simd_level get_simd_level()
+	{
+		static const auto level = detect_simd_level();
+		return level;
+	}
+
+	std::string_view get_simd_level_name(simd_level level)
+	{
+		switch (level)
+		{
+		case simd_level::avx2: return "AVX2";
+		case simd_level::sse2: return "SSE2";
+		default:               return "Scalar";
+		}
+	}
+
+	const uint8_t* find_first(const ida_pattern& pattern, const uint8_t* begin, size_t size)
+	{
+		if (pattern.size() == 0 || pattern.size() > size)
+		{
+			return nullptr;
+		}
+
+		const auto rarest          = pattern.m_anchor_index;
+		const auto second          = pattern.m_second_anchor_index;
+		const auto rarest_byte     = pattern.m_bytes[rarest];
+		const auto second_byte     = pattern.m_bytes[second];
+		const auto last_start      = size - pattern.size();
+		const auto furthest_anchor = std::max(rarest, second);
+		const auto level           = get_simd_level();
+		size_t start               = 0;
+
+		if (level == simd_level::avx2)
+		{
+			const auto rarest_vector = _mm256_set1_epi8(static_cast<char>(rarest_byte));
+			const auto second_vector = _mm256_set1_epi8(static_cast<char>(second_byte));
+
+			for (; start + furthest_anchor + 32 <= size; start += 32)
+			{
+				const auto rarest_hits = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin + start + rarest)), rarest_vector);
+				const auto second_hits = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin + start + second)), second_vector);
+
+				auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(rarest_hits, second_hits)));
+				while (mask)
+				{
+					const auto candidate = start + std::countr_zero(mask);
+					if (candidate <= last_start && pattern.matches(begin + candidate))
+					{
+						return begin + candidate;
+					}
+
+					mask &= mask - 1;
+				}
+			}
+		}
+		else if (level == simd_level::sse2)
+		{
+			const auto rarest_vector = _mm_set1_epi8(static_cast<char>(rarest_byte));
+			const auto second_vector = _mm_set1_epi8(static_cast<char>(second_byte));
+
+			for (; start + furthest_anchor + 16 <= size; start += 16)
+			{
+				const auto rarest_hits = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin + start + rarest)), rarest_vector);
+				const auto second_hits = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin + start + second)), second_vector);
+
+				auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(rarest_hits, second_hits)));
+				while (mask)
+				{
+					const auto candidate = start + std::countr_zero(mask);
+					if (candidate <= last_start && pattern.matches(begin + candidate))
+					{
+						return begin + candidate;
+					}
+
+					mask &= mask - 1;
+				}
+			}
+		}
+
+		if (level != simd_level::scalar)
+		{
+			for (; start <= last_start; start++)
+			{
+				if (begin[start + rarest] == rarest_byte && begin[start + second] == second_byte && pattern.matches(begin + start))
+				{
+					return begin + start;
+				}
+			}
+
+			return nullptr;
+		}
+
+		// No vector unit to lean on, Horspool skips ahead based on the byte found under the last byte of the pattern.
+		const auto last_index = pattern.size() - 1;
+		while (start <= last_start)
+		{
+			if (pattern.matches(begin + start))
+			{
+				return begin + start;
+			}
+
+			start += pattern.m_skip[begin[start + last_index]];
+		}
+
+		return nullptr;
+	}
+} // namespace big::signatures
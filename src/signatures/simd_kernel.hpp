@@ -0,0 +1,111 @@
+#pragma once
+
+#include "ida_pattern.hpp"
+
+#include <bit>
+#include <immintrin.h>
+#include <span>
+
+namespace big::signatures
+{
+	enum class simd_level : uint8_t
+	{
+		scalar,
+		sse2,
+		avx2,
+	};
+
+	// Detected once through cpuid, AVX2 also requires the OS to save the ymm registers. SSE2 is always there on x64.
+	simd_level get_simd_level();
+
+	std::string_view get_simd_level_name(simd_level level);
+
+	// Returns the first match of the pattern inside [begin, begin + size), or nullptr.
+	// Candidates are found 32 (AVX2) or 16 (SSE2) positions at a time by comparing the two rarest fixed bytes of the pattern,
+	// only those positions get the full masked comparison.
+	const uint8_t* find_first(const ida_pattern& pattern, const uint8_t* begin, size_t size);
+
+	// Calls visitor(pos) for every position of [begin, begin + size) holding one of the needle bytes, in increasing order.
+	// Stops as soon as the visitor returns false.
+	template<typename Visitor>
+	void for_each_candidate(simd_level level, const uint8_t* begin, size_t size, std::span<const uint8_t> needles, Visitor&& visitor)
+	{
+		std::array<bool, 256> is_needle{};
+		for (const auto needle : needles)
+		{
+			is_needle[needle] = true;
+		}
+
+		size_t pos = 0;
+
+		if (level == simd_level::avx2)
+		{
+			__m256i needle_vectors[256];
+			for (size_t i = 0; i < needles.size(); i++)
+			{
+				needle_vectors[i] = _mm256_set1_epi8(static_cast<char>(needles[i]));
+			}
+
+			for (; pos + 32 <= size; pos += 32)
+			{
+				const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin + pos));
+
+				auto hits = _mm256_setzero_si256();
+				for (size_t i = 0; i < needles.size(); i++)
+				{
+					hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, needle_vectors[i]));
+				}
+
+				auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+				while (mask)
+				{
+					if (!visitor(pos + std::countr_zero(mask)))
+					{
+						return;
+					}
+
+					mask &= mask - 1;
+				}
+			}
+		}
+		else if (level == simd_level::sse2)
+		{
+			__m128i needle_vectors[256];
+			for (size_t i = 0; i < needles.size(); i++)
+			{
+				needle_vectors[i] = _mm_set1_epi8(static_cast<char>(needles[i]));
+			}
+
+			for (; pos + 16 <= size; pos += 16)
+			{
+				const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin + pos));
+
+				auto hits = _mm_setzero_si128();
+				for (size_t i = 0; i < needles.size(); i++)
+				{
+					hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, needle_vectors[i]));
+				}
+
+				auto mask = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+				while (mask)
+				{
+					if (!visitor(pos + std::countr_zero(mask)))
+					{
+						return;
+					}
+
+					mask &= mask - 1;
+				}
+			}
+		}
+
+		// Scalar fallback, also handles the tail the vector loops couldn't cover.
+		for (; pos < size; pos++)
+		{
+			if (is_needle[begin[pos]] && !visitor(pos))
+			{
+				return;
+			}
+		}
+	}
+} // namespace big::signatures
@@ -0,0 +1,413 @@
+#include "merge.hpp"
+
+#include <map>
+#include <unordered_set>
+
+namespace big::sjson
+{
+	static std::string join_key(const std::string& path, std::string_view key)
+	{
+		return path.empty() ? std::string(key) : std::format("{}.{}", path, key);
+	}
+
+	// Decoded Name of every item, when they all have a unique one that can be used in a selector.
+	static std::optional<std::vector<std::string>> get_item_names(const value& array)
+	{
+		std::vector<std::string> res;
+		std::unordered_set<std::string> seen;
+		for (const auto& item : array.m_items)
+		{
+			const auto name = item.find_key("Name");
+			if (!name || (name->m_type != value_type::string && name->m_type != value_type::literal))
+			{
+				return std::nullopt;
+			}
+
+			auto text = name->get_decoded_text();
+			if (text.contains(']') || !seen.insert(text).second)
+			{
+				return std::nullopt;
+			}
+
+			res.push_back(std::move(text));
+		}
+
+		return res;
+	}
+
+	static void diff_object(const value& base, const value& modified, const std::string& path, std::vector<change>& output)
+	{
+		const auto diff_key = [&](size_t i)
+		{
+			const auto child_path = join_key(path, modified.m_keys[i]);
+			if (const auto old = base.find_key(modified.m_keys[i]))
+			{
+				diff(*old, modified.m_items[i], child_path, output);
+			}
+			else
+			{
+				output.push_back({.m_kind = change::kind::set, .m_path = child_path, .m_value = modified.m_items[i]});
+			}
+		};
+
+		// Name goes last, the paths of the other changes may select the object through it.
+		std::optional<size_t> name_index;
+		for (size_t i = 0; i < modified.m_keys.size(); i++)
+		{
+			if (modified.m_keys[i] == "Name")
+			{
+				name_index = i;
+				continue;
+			}
+
+			diff_key(i);
+		}
+
+		for (const auto& key : base.m_keys)
+		{
+			if (!modified.find_key(key))
+			{
+				output.push_back({.m_kind = change::kind::remove, .m_path = join_key(path, key)});
+			}
+		}
+
+		if (name_index)
+		{
+			diff_key(*name_index);
+		}
+	}
+
+	void diff(const value& base, const value& modified, const std::string& path, std::vector<change>& output)
+	{
+		if (base == modified)
+		{
+			return;
+		}
+
+		if (base.m_type == value_type::object && modified.m_type == value_type::object && std::ranges::all_of(base.m_keys, is_addressable_key)
+		    && std::ranges::all_of(modified.m_keys, is_addressable_key))
+		{
+			diff_object(base, modified, path, output);
+			return;
+		}
+
+		if (base.m_type == value_type::array && modified.m_type == value_type::array)
+		{
+			const auto base_names     = get_item_names(base);
+			const auto modified_names = get_item_names(modified);
+			if (base_names && modified_names)
+			{
+				std::unordered_map<std::string_view, size_t> base_positions;
+				for (size_t i = 0; i < base_names->size(); i++)
+				{
+					base_positions.emplace((*base_names)[i], i);
+				}
+
+				// Base position of each modified item, none for new ones.
+				std::vector<std::optional<size_t>> modified_positions(modified_names->size());
+				std::vector<bool> is_kept(base_names->size());
+				size_t last_kept_index = 0;
+				bool is_reordered      = false;
+				std::optional<size_t> previous_position;
+				for (size_t i = 0; i < modified_names->size(); i++)
+				{
+					const auto it = base_positions.find((*modified_names)[i]);
+					if (it == base_positions.end())
+					{
+						continue;
+					}
+
+					modified_positions[i]  = it->second;
+					is_kept[it->second]    = true;
+					last_kept_index        = i + 1;
+					is_reordered          |= previous_position && it->second < *previous_position;
+					previous_position      = it->second;
+				}
+
+				// Moving items around can't be told item by item.
+				if (!is_reordered)
+				{
+					for (size_t i = 0; i < base_names->size(); i++)
+					{
+						if (!is_kept[i])
+						{
+							output.push_back({.m_kind = change::kind::remove, .m_path = std::format("{}[Name={}]", path, (*base_names)[i])});
+						}
+					}
+
+					// Removes come first, so that each new item goes in at its position in modified once the ones before it are in.
+					// New items past the last kept one are appended, which still holds once other patches added or removed items.
+					for (size_t i = 0; i < modified_names->size(); i++)
+					{
+						if (modified_positions[i])
+						{
+							diff(base.m_items[*modified_positions[i]], modified.m_items[i], std::format("{}[Name={}]", path, (*base_names)[*modified_positions[i]]), output);
+							continue;
+						}
+
+						auto& insert = output.emplace_back(change{.m_kind = change::kind::insert, .m_path = path, .m_value = modified.m_items[i]});
+						if (i < last_kept_index)
+						{
+							insert.m_index = i + 1;
+						}
+					}
+					return;
+				}
+			}
+		}
+
+		output.push_back({.m_kind = change::kind::set, .m_path = path, .m_value = modified});
+	}
+
+	// Calls visitor with every strict parent of the path, selector contents are skipped over.
+	template<typename Visitor>
+	static void for_each_parent(std::string_view path, Visitor&& visitor)
+	{
+		bool is_in_selector = false;
+		for (size_t i = 0; i < path.size(); i++)
+		{
+			if (is_in_selector)
+			{
+				is_in_selector = path[i] != ']';
+			}
+			else if (path[i] == '.' || path[i] == '[')
+			{
+				visitor(path.substr(0, i));
+				is_in_selector = path[i] == '[';
+			}
+		}
+	}
+
+	static bool are_compatible(const change& left, const change& right)
+	{
+		// Two inserts both land, two removes or two identical sets agree.
+		return left.m_kind == right.m_kind && (left.m_kind == change::kind::insert || left.m_value == right.m_value);
+	}
+
+	static void apply(value& root, change&& change)
+	{
+		switch (change.m_kind)
+		{
+		case change::kind::set:    set(root, change.m_path, std::move(change.m_value)); break;
+		case change::kind::insert: insert(root, change.m_path, std::move(change.m_value), change.m_index); break;
+		case change::kind::remove: remove(root, change.m_path); break;
+		}
+	}
+
+	std::vector<conflict> merge(value& root, std::span<patch> patches)
+	{
+		struct touch
+		{
+			size_t m_patch;
+			const change* m_change;
+		};
+
+		std::unordered_map<std::string_view, std::vector<touch>> touches;
+		for (size_t i = 0; i < patches.size(); i++)
+		{
+			for (const auto& change : patches[i].m_changes)
+			{
+				touches[change.m_path].emplace_back(i, &change);
+
+				// Renaming an item changes which item the [Name=...] paths of the other patches land on.
+				const std::string_view path = change.m_path;
+				if (change.m_kind != change::kind::insert && path.ends_with("].Name"))
+				{
+					touches[path.substr(0, path.size() - 5)].emplace_back(i, &change);
+				}
+			}
+		}
+
+		// Sorted by path so that reports come out in a stable order.
+		std::map<std::string_view, std::set<size_t>> conflicting_patches;
+		for (const auto& [path, path_touches] : touches)
+		{
+			for (size_t i = 0; i < path_touches.size(); i++)
+			{
+				for (size_t j = i + 1; j < path_touches.size(); j++)
+				{
+					const auto& left  = path_touches[i];
+					const auto& right = path_touches[j];
+					if (patches[left.m_patch].m_name != patches[right.m_patch].m_name && !are_compatible(*left.m_change, *right.m_change))
+					{
+						conflicting_patches[path].insert({left.m_patch, right.m_patch});
+					}
+				}
+			}
+
+			for_each_parent(path,
+			                [&](std::string_view parent)
+			                {
+				                const auto it = touches.find(parent);
+				                if (it == touches.end())
+				                {
+					                return;
+				                }
+
+				                // Inserting into an array doesn't touch the items already in it.
+				                for (const auto& parent_touch : it->second)
+				                {
+					                if (parent_touch.m_change->m_kind == change::kind::insert)
+					                {
+						                continue;
+					                }
+
+					                for (const auto& path_touch : path_touches)
+					                {
+						                if (patches[parent_touch.m_patch].m_name != patches[path_touch.m_patch].m_name)
+						                {
+							                conflicting_patches[path].insert({parent_touch.m_patch, path_touch.m_patch});
+						                }
+					                }
+				                }
+			                });
+		}
+
+		std::vector<conflict> res;
+		for (const auto& [path, patch_indices] : conflicting_patches)
+		{
+			auto& new_conflict  = res.emplace_back();
+			new_conflict.m_path = path;
+			for (const auto patch_index : patch_indices)
+			{
+				const auto& name = patches[patch_index].m_name;
+				if (std::ranges::find(new_conflict.m_patch_names, name) == new_conflict.m_patch_names.end())
+				{
+					new_conflict.m_patch_names.push_back(name);
+				}
+			}
+		}
+
+		for (auto& patch : patches)
+		{
+			for (auto& change : patch.m_changes)
+			{
+				apply(root, std::move(change));
+			}
+		}
+
+		return res;
+	}
+
+	patch_recorder::patch_recorder(value& root, patch& output) :
+	    m_root(root),
+	    m_patch(output)
+	{
+	}
+
+	patch_recorder::~patch_recorder()
+	{
+		for (auto it = m_undo_log.rbegin(); it != m_undo_log.rend(); ++it)
+		{
+			auto& parent = at(m_root, it->m_parent);
+			switch (it->m_kind)
+			{
+			case undo_entry::kind::replace:
+			{
+				parent.m_items[it->m_index] = std::move(it->m_old_value);
+				break;
+			}
+			case undo_entry::kind::erase:
+			{
+				if (parent.m_type == value_type::object)
+				{
+					parent.m_keys.erase(parent.m_keys.begin() + it->m_index);
+				}
+				parent.m_items.erase(parent.m_items.begin() + it->m_index);
+				break;
+			}
+			case undo_entry::kind::reinsert:
+			{
+				if (parent.m_type == value_type::object)
+				{
+					parent.m_keys.insert(parent.m_keys.begin() + it->m_index, std::move(it->m_key));
+				}
+				parent.m_items.insert(parent.m_items.begin() + it->m_index, std::move(it->m_old_value));
+				break;
+			}
+			}
+		}
+	}
+
+	const value* patch_recorder::find(std::string_view path) const
+	{
+		return sjson::find(m_root, path);
+	}
+
+	bool patch_recorder::set(std::string_view path, value new_value)
+	{
+		bool is_complete = false;
+		auto location    = locate(m_root, path, is_complete);
+		if (is_complete)
+		{
+			auto& target = at(m_root, location);
+			diff(target, new_value, get_canonical_path(m_root, location), m_patch.m_changes);
+
+			const auto index = location.back();
+			location.pop_back();
+			m_undo_log.push_back({.m_kind = undo_entry::kind::replace, .m_parent = std::move(location), .m_index = index, .m_old_value = std::exchange(target, std::move(new_value))});
+			return true;
+		}
+
+		const auto existing_depth = location.size();
+		if (!sjson::set(m_root, path, std::move(new_value)))
+		{
+			return false;
+		}
+
+		location = locate(m_root, path, is_complete);
+		m_patch.m_changes.push_back({.m_kind = change::kind::set, .m_path = get_canonical_path(m_root, location), .m_value = at(m_root, location)});
+
+		// Only the first created key has to go, the others are inside it.
+		const auto index = location[existing_depth];
+		location.resize(existing_depth);
+		m_undo_log.push_back({.m_kind = undo_entry::kind::erase, .m_parent = std::move(location), .m_index = index});
+		return true;
+	}
+
+	bool patch_recorder::insert(std::string_view path, value new_value, std::optional<size_t> index)
+	{
+		bool is_complete    = false;
+		auto location       = locate(m_root, path, is_complete);
+		auto& array         = at(m_root, location);
+		const auto position = index.value_or(array.m_items.size() + 1) - 1;
+		if (!is_complete || array.m_type != value_type::array || position > array.m_items.size())
+		{
+			return false;
+		}
+
+		m_patch.m_changes.push_back({.m_kind = change::kind::insert, .m_path = get_canonical_path(m_root, location), .m_value = new_value, .m_index = index});
+
+		array.m_items.insert(array.m_items.begin() + position, std::move(new_value));
+		m_undo_log.push_back({.m_kind = undo_entry::kind::erase, .m_parent = std::move(location), .m_index = position});
+		return true;
+	}
+
+	bool patch_recorder::remove(std::string_view path)
+	{
+		bool is_complete = false;
+		auto location    = locate(m_root, path, is_complete);
+		if (!is_complete)
+		{
+			return false;
+		}
+
+		m_patch.m_changes.push_back({.m_kind = change::kind::remove, .m_path = get_canonical_path(m_root, location)});
+
+		const auto index = location.back();
+		location.pop_back();
+		auto& parent = at(m_root, location);
+
+		undo_entry entry{.m_kind = undo_entry::kind::reinsert, .m_index = index, .m_old_value = std::move(parent.m_items[index])};
+		if (parent.m_type == value_type::object)
+		{
+			entry.m_key = std::move(parent.m_keys[index]);
+			parent.m_keys.erase(parent.m_keys.begin() + index);
+		}
+		parent.m_items.erase(parent.m_items.begin() + index);
+
+		entry.m_parent = std::move(location);
+		m_undo_log.push_back(std::move(entry));
+		return true;
+	}
+} // namespace big::sjson
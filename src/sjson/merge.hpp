@@ -0,0 +1,89 @@
+#pragma once
+
+#include "sjson.hpp"
+
+namespace big::sjson
+{
+	struct change
+	{
+		enum class kind : uint8_t
+		{
+			set,
+			insert,
+			remove,
+		};
+
+		kind m_kind = kind::set;
+		// Canonical, see get_canonical_path, so that it still lands on the right item once other patches added or removed some.
+		// Points to the array for inserts.
+		std::string m_path;
+		value m_value;
+		// Inserts only, 1-based, appended when empty.
+		std::optional<size_t> m_index;
+	};
+
+	struct patch
+	{
+		// Guid of the mod the patch comes from, changes of a same patch never conflict with each other.
+		std::string m_name;
+		std::vector<change> m_changes;
+	};
+
+	struct conflict
+	{
+		std::string m_path;
+		// In application order, the last one wins.
+		std::vector<std::string> m_patch_names;
+	};
+
+	// Appends the changes turning base into modified, path being where base sits in the document.
+	// Objects are compared key by key, arrays whose items all have a unique Name item by item, anything else as a whole.
+	// Named arrays whose remaining items changed order are set as a whole too, new named items are inserted at their position.
+	void diff(const value& base, const value& modified, const std::string& path, std::vector<change>& output);
+
+	// Applies the patches onto root in order, in a single pass over their changes, which get moved out of the patches.
+	// A path is in conflict when patches with different names change it, or change it and one of its parents, to different values.
+	// The last of them wins, which is what running the patches one after the other would have given,
+	// except for an item renamed by one patch and edited through its old name by another: those edits no longer find it.
+	std::vector<conflict> merge(value& root, std::span<patch> patches);
+
+	// Runs the edits of one patch against root: they are applied right away so that the patch sees its own edits,
+	// and recorded as changes relative to root as it was. Root gets restored when the recorder is destroyed,
+	// at a cost proportional to the edits rather than to the document.
+	class patch_recorder
+	{
+	public:
+		patch_recorder(value& root, patch& output);
+		~patch_recorder();
+
+		patch_recorder(const patch_recorder&)            = delete;
+		patch_recorder& operator=(const patch_recorder&) = delete;
+
+		const value* find(std::string_view path) const;
+		bool set(std::string_view path, value new_value);
+		bool insert(std::string_view path, value new_value, std::optional<size_t> index = std::nullopt);
+		bool remove(std::string_view path);
+
+	private:
+		struct undo_entry
+		{
+			enum class kind : uint8_t
+			{
+				replace,
+				erase,
+				reinsert,
+			};
+
+			kind m_kind;
+			// Positions in m_items from the root to the parent of the edited value, positions stay valid as the log is undone backwards.
+			std::vector<size_t> m_parent;
+			size_t m_index = 0;
+			std::string m_key;
+			value m_old_value;
+		};
+
+		value& m_root;
+		patch& m_patch;
+		std::vector<undo_entry> m_undo_log;
+	};
+} // namespace big::sjson
@@ -0,0 +1,944 @@
+#include "sjson.hpp"
+
+#include <bit>
+#include <charconv>
+#include <intrin.h>
+
+namespace big::sjson
+{
+	// Game files nest a handful of levels deep, anything deeper is treated as malformed rather than risking the stack.
+	static constexpr size_t max_depth = 256;
+
+	// Commas are optional separators, they are skipped like whitespace.
+	static bool is_blank(char c)
+	{
+		return static_cast<uint8_t>(c) <= ' ' || c == ',';
+	}
+
+	static bool is_literal_end(char c)
+	{
+		return is_blank(c) || c == '=' || c == ':' || c == '"' || c == '{' || c == '}' || c == '[' || c == ']';
+	}
+
+	// First position at or after pos that isn't blank, 16 bytes at a time.
+	static size_t skip_blanks(std::string_view text, size_t pos)
+	{
+		const auto space = _mm_set1_epi8(' ');
+		const auto comma = _mm_set1_epi8(',');
+		for (; pos + 16 <= text.size(); pos += 16)
+		{
+			const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos));
+			// Bytes up to ' ' are the only ones the unsigned max leaves at ' '.
+			const auto blanks = _mm_or_si128(_mm_cmpeq_epi8(_mm_max_epu8(block, space), space), _mm_cmpeq_epi8(block, comma));
+			const auto mask   = ~static_cast<uint32_t>(_mm_movemask_epi8(blanks)) & 0xFF'FF;
+			if (mask)
+			{
+				return pos + std::countr_zero(mask);
+			}
+		}
+
+		while (pos < text.size() && is_blank(text[pos]))
+		{
+			pos++;
+		}
+
+		return pos;
+	}
+
+	// Strings are scanned 16 bytes at a time, only quotes and backslashes need a closer look.
+	static size_t find_quote_or_backslash(std::string_view text, size_t pos)
+	{
+		const auto quote     = _mm_set1_epi8('"');
+		const auto backslash = _mm_set1_epi8('\\');
+		for (; pos + 16 <= text.size(); pos += 16)
+		{
+			const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos));
+			const auto mask  = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash))));
+			if (mask)
+			{
+				return pos + std::countr_zero(mask);
+			}
+		}
+
+		for (; pos < text.size(); pos++)
+		{
+			if (text[pos] == '"' || text[pos] == '\\')
+			{
+				return pos;
+			}
+		}
+
+		return std::string_view::npos;
+	}
+
+	static void append_utf8(std::string& out, uint32_t code_point)
+	{
+		if (code_point < 0x80)
+		{
+			out += static_cast<char>(code_point);
+		}
+		else if (code_point < 0x8'00)
+		{
+			out += static_cast<char>(0xC0 | (code_point >> 6));
+			out += static_cast<char>(0x80 | (code_point & 0x3F));
+		}
+		else if (code_point < 0x1'00'00)
+		{
+			out += static_cast<char>(0xE0 | (code_point >> 12));
+			out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+			out += static_cast<char>(0x80 | (code_point & 0x3F));
+		}
+		else
+		{
+			out += static_cast<char>(0xF0 | (code_point >> 18));
+			out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+			out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+			out += static_cast<char>(0x80 | (code_point & 0x3F));
+		}
+	}
+
+	static std::optional<uint32_t> parse_hex4(std::string_view text)
+	{
+		uint32_t res = 0;
+		if (text.size() < 4 || std::from_chars(text.data(), text.data() + 4, res, 16).ptr != text.data() + 4)
+		{
+			return std::nullopt;
+		}
+
+		return res;
+	}
+
+	static std::string unescape(std::string_view raw)
+	{
+		std::string res;
+		res.reserve(raw.size());
+		for (size_t i = 0; i < raw.size(); i++)
+		{
+			if (raw[i] != '\\' || i + 1 == raw.size())
+			{
+				res += raw[i];
+				continue;
+			}
+
+			switch (const auto c = raw[++i])
+			{
+			case 'n':  res += '\n'; break;
+			case 'r':  res += '\r'; break;
+			case 't':  res += '\t'; break;
+			case 'b':  res += '\b'; break;
+			case 'f':  res += '\f'; break;
+			case 'u':
+			{
+				auto code_point = parse_hex4(raw.substr(i + 1));
+				if (!code_point)
+				{
+					res += c;
+					break;
+				}
+				i += 4;
+
+				// Surrogate pair.
+				if (*code_point >= 0xD8'00 && *code_point < 0xDC'00 && raw.substr(i + 1, 2) == "\\u")
+				{
+					const auto low = parse_hex4(raw.substr(i + 3));
+					if (low && *low >= 0xDC'00 && *low < 0xE0'00)
+					{
+						code_point  = 0x1'00'00 + ((*code_point - 0xD8'00) << 10) + (*low - 0xDC'00);
+						i          += 6;
+					}
+				}
+
+				append_utf8(res, *code_point);
+				break;
+			}
+			default: res += c; break;
+			}
+		}
+
+		return res;
+	}
+
+	static std::string escape(std::string_view decoded)
+	{
+		std::string res;
+		res.reserve(decoded.size());
+		for (const auto c : decoded)
+		{
+			switch (c)
+			{
+			case '"':  res += "\\\""; break;
+			case '\\': res += "\\\\"; break;
+			case '\n': res += "\\n"; break;
+			case '\r': res += "\\r"; break;
+			case '\t': res += "\\t"; break;
+			default:
+				if (static_cast<uint8_t>(c) < ' ')
+				{
+					res += std::format("\\u{:04x}", static_cast<uint8_t>(c));
+				}
+				else
+				{
+					res += c;
+				}
+				break;
+			}
+		}
+
+		return res;
+	}
+
+	value value::make_string(std::string_view decoded)
+	{
+		value res;
+		res.m_type = value_type::string;
+		res.m_text = escape(decoded);
+		return res;
+	}
+
+	value* value::find_key(std::string_view key)
+	{
+		return const_cast<value*>(static_cast<const value&>(*this).find_key(key));
+	}
+
+	const value* value::find_key(std::string_view key) const
+	{
+		if (m_type != value_type::object)
+		{
+			return nullptr;
+		}
+
+		for (size_t i = 0; i < m_keys.size(); i++)
+		{
+			if (m_keys[i] == key)
+			{
+				return &m_items[i];
+			}
+		}
+
+		return nullptr;
+	}
+
+	std::string value::get_decoded_text() const
+	{
+		if (m_type == value_type::string && !m_is_multiline)
+		{
+			return unescape(m_text);
+		}
+
+		return m_text;
+	}
+
+	class parser
+	{
+	public:
+		explicit parser(std::string_view text) :
+		    m_text(text)
+		{
+		}
+
+		std::optional<document> parse_document(std::string* error)
+		{
+			document res;
+
+			skip_whitespace();
+			res.m_has_root_braces = peek() == '{';
+			if (res.m_has_root_braces)
+			{
+				m_pos++;
+			}
+
+			if (parse_object_body(res.m_root, res.m_has_root_braces ? '}' : '\0', 0))
+			{
+				skip_whitespace();
+				if (m_pos == m_text.size())
+				{
+					return res;
+				}
+
+				fail("unexpected content after the root object");
+			}
+
+			if (error)
+			{
+				*error = std::move(m_error);
+			}
+
+			return std::nullopt;
+		}
+
+	private:
+		// '\0' past the end, which is also how the end of an unbraced root object is spelled.
+		char peek() const
+		{
+			return m_pos < m_text.size() ? m_text[m_pos] : '\0';
+		}
+
+		bool fail(std::string_view message)
+		{
+			const auto consumed = m_text.substr(0, m_pos);
+			const auto line     = std::ranges::count(consumed, '\n') + 1;
+			const auto column   = m_pos - (consumed.rfind('\n') + 1) + 1;
+
+			m_error = std::format("{} (line {}, column {})", message, line, column);
+			return false;
+		}
+
+		void skip_whitespace()
+		{
+			while (true)
+			{
+				m_pos = skip_blanks(m_text, m_pos);
+
+				const auto rest = m_text.substr(m_pos);
+				if (rest.starts_with("//"))
+				{
+					const auto end = rest.find('\n');
+					m_pos          = end == std::string_view::npos ? m_text.size() : m_pos + end;
+				}
+				else if (rest.starts_with("/*"))
+				{
+					const auto end = rest.find("*/", 2);
+					m_pos          = end == std::string_view::npos ? m_text.size() : m_pos + end + 2;
+				}
+				else
+				{
+					return;
+				}
+			}
+		}
+
+		bool parse_object_body(value& out, char end, size_t depth)
+		{
+			out.m_type = value_type::object;
+
+			while (true)
+			{
+				skip_whitespace();
+				if (end == '\0' ? m_pos == m_text.size() : peek() == end)
+				{
+					if (end != '\0')
+					{
+						m_pos++;
+					}
+					return true;
+				}
+
+				if (m_pos >= m_text.size())
+				{
+					return fail("unexpected end of file, missing '}'");
+				}
+
+				std::string key;
+				if (!parse_key(key))
+				{
+					return false;
+				}
+
+				skip_whitespace();
+				if (peek() != '=' && peek() != ':')
+				{
+					return fail("expected '=' after the key");
+				}
+				m_pos++;
+
+				skip_whitespace();
+				value item;
+				if (!parse_value(item, depth + 1))
+				{
+					return false;
+				}
+
+				out.m_keys.push_back(std::move(key));
+				out.m_items.push_back(std::move(item));
+			}
+		}
+
+		bool parse_array_body(value& out, size_t depth)
+		{
+			out.m_type = value_type::array;
+
+			while (true)
+			{
+				skip_whitespace();
+				if (peek() == ']')
+				{
+					m_pos++;
+					return true;
+				}
+
+				if (m_pos >= m_text.size())
+				{
+					return fail("unexpected end of file, missing ']'");
+				}
+
+				value item;
+				if (!parse_value(item, depth + 1))
+				{
+					return false;
+				}
+
+				out.m_items.push_back(std::move(item));
+			}
+		}
+
+		bool parse_key(std::string& out)
+		{
+			if (peek() == '"')
+			{
+				value key;
+				if (!parse_string(key))
+				{
+					return false;
+				}
+
+				out = key.get_decoded_text();
+				return true;
+			}
+
+			const auto start = m_pos;
+			while (m_pos < m_text.size() && !is_literal_end(m_text[m_pos]))
+			{
+				m_pos++;
+			}
+
+			if (m_pos == start)
+			{
+				return fail(std::format("unexpected '{}', expected a key", peek()));
+			}
+
+			out = m_text.substr(start, m_pos - start);
+			return true;
+		}
+
+		bool parse_string(value& out)
+		{
+			out.m_type = value_type::string;
+
+			if (m_text.substr(m_pos, 3) == R"(""")")
+			{
+				const auto end = m_text.find(R"(""")", m_pos + 3);
+				if (end == std::string_view::npos)
+				{
+					return fail("unterminated \"\"\" string");
+				}
+
+				out.m_is_multiline = true;
+				out.m_text         = m_text.substr(m_pos + 3, end - m_pos - 3);
+				m_pos              = end + 3;
+				return true;
+			}
+
+			const auto start = ++m_pos;
+			while (true)
+			{
+				const auto pos = find_quote_or_backslash(m_text, m_pos);
+				if (pos == std::string_view::npos)
+				{
+					m_pos = start - 1;
+					return fail("unterminated string");
+				}
+
+				if (m_text[pos] == '"')
+				{
+					out.m_text = m_text.substr(start, pos - start);
+					m_pos      = pos + 1;
+					return true;
+				}
+
+				// Skip whatever got escaped.
+				m_pos = pos + 2;
+			}
+		}
+
+		bool parse_value(value& out, size_t depth)
+		{
+			if (depth > max_depth)
+			{
+				return fail("too deeply nested");
+			}
+
+			switch (peek())
+			{
+			case '{': m_pos++; return parse_object_body(out, '}', depth);
+			case '[': m_pos++; return parse_array_body(out, depth);
+			case '"': return parse_string(out);
+			default:  break;
+			}
+
+			const auto start = m_pos;
+			while (m_pos < m_text.size() && !is_literal_end(m_text[m_pos]))
+			{
+				m_pos++;
+			}
+
+			const auto literal = m_text.substr(start, m_pos - start);
+			if (literal.empty())
+			{
+				return m_pos >= m_text.size() ? fail("unexpected end of file, expected a value") : fail(std::format("unexpected '{}', expected a value", peek()));
+			}
+
+			if (literal == "true" || literal == "false")
+			{
+				out.m_type    = value_type::boolean;
+				out.m_boolean = literal == "true";
+			}
+			else if (literal != "null")
+			{
+				out.m_type = value_type::literal;
+				out.m_text = literal;
+			}
+
+			return true;
+		}
+
+		std::string_view m_text;
+		size_t m_pos = 0;
+		std::string m_error;
+	};
+
+	std::optional<document> parse(std::string_view text, std::string* error)
+	{
+		return parser(text).parse_document(error);
+	}
+
+	static bool is_plain_key(std::string_view key)
+	{
+		return !key.empty() && std::ranges::all_of(key,
+		                                           [](char c)
+		                                           {
+			                                           return isalnum(static_cast<uint8_t>(c)) || c == '_';
+		                                           });
+	}
+
+	static void write_value(std::string& out, const value& value, size_t depth);
+
+	static void write_members(std::string& out, const value& object, size_t depth)
+	{
+		for (size_t i = 0; i < object.m_keys.size(); i++)
+		{
+			out.append(depth, '\t');
+			if (is_plain_key(object.m_keys[i]))
+			{
+				out += object.m_keys[i];
+			}
+			else
+			{
+				out += '"';
+				out += escape(object.m_keys[i]);
+				out += '"';
+			}
+			out += " = ";
+			write_value(out, object.m_items[i], depth);
+			out += '\n';
+		}
+	}
+
+	static void write_value(std::string& out, const value& value, size_t depth)
+	{
+		switch (value.m_type)
+		{
+		case value_type::null:    out += "null"; break;
+		case value_type::boolean: out += value.m_boolean ? "true" : "false"; break;
+		case value_type::literal: out += value.m_text; break;
+		case value_type::string:
+		{
+			const std::string_view quote = value.m_is_multiline ? R"(""")" : "\"";
+			out += quote;
+			out += value.m_text;
+			out += quote;
+			break;
+		}
+		case value_type::array:
+		{
+			if (value.m_items.empty())
+			{
+				out += "[]";
+				break;
+			}
+
+			out += "[\n";
+			for (const auto& item : value.m_items)
+			{
+				out.append(depth + 1, '\t');
+				write_value(out, item, depth + 1);
+				out += '\n';
+			}
+			out.append(depth, '\t');
+			out += ']';
+			break;
+		}
+		case value_type::object:
+		{
+			if (value.m_items.empty())
+			{
+				out += "{}";
+				break;
+			}
+
+			out += "{\n";
+			write_members(out, value, depth + 1);
+			out.append(depth, '\t');
+			out += '}';
+			break;
+		}
+		}
+	}
+
+	std::string serialize(const document& document, size_t size_hint)
+	{
+		std::string res;
+		res.reserve(size_hint);
+
+		if (document.m_has_root_braces)
+		{
+			write_value(res, document.m_root, 0);
+			res += '\n';
+		}
+		else
+		{
+			write_members(res, document.m_root, 0);
+		}
+
+		return res;
+	}
+
+	struct path_segment
+	{
+		enum class kind : uint8_t
+		{
+			key,
+			index,
+			match,
+		};
+
+		kind m_kind = kind::key;
+		// Object key, or the field compared by a match selector.
+		std::string_view m_key;
+		std::string_view m_match_value;
+		// 0-based.
+		size_t m_index = 0;
+	};
+
+	static std::optional<std::vector<path_segment>> parse_path(std::string_view path)
+	{
+		std::vector<path_segment> res;
+
+		size_t pos = 0;
+		while (true)
+		{
+			const auto key_end = path.find_first_of(".[", pos);
+			const auto key     = path.substr(pos, key_end - pos);
+			if (key.empty())
+			{
+				return std::nullopt;
+			}
+			res.emplace_back(path_segment::kind::key, key);
+			pos = key_end;
+
+			while (pos < path.size() && path[pos] == '[')
+			{
+				const auto selector_end = path.find(']', pos);
+				if (selector_end == std::string_view::npos)
+				{
+					return std::nullopt;
+				}
+
+				const auto selector = path.substr(pos + 1, selector_end - pos - 1);
+				pos                 = selector_end + 1;
+
+				if (const auto equal = selector.find('='); equal != std::string_view::npos)
+				{
+					res.emplace_back(path_segment::kind::match, selector.substr(0, equal), selector.substr(equal + 1));
+					continue;
+				}
+
+				size_t index = 0;
+				if (std::from_chars(selector.data(), selector.data() + selector.size(), index).ptr != selector.data() + selector.size() || index == 0)
+				{
+					return std::nullopt;
+				}
+				res.emplace_back(path_segment::kind::index, std::string_view{}, std::string_view{}, index - 1);
+			}
+
+			if (pos >= path.size())
+			{
+				return res;
+			}
+
+			if (path[pos] != '.')
+			{
+				return std::nullopt;
+			}
+			pos++;
+		}
+	}
+
+	static bool text_equals(const value& value, std::string_view text)
+	{
+		if (value.m_type == value_type::string && !value.m_is_multiline && value.m_text.contains('\\'))
+		{
+			return value.get_decoded_text() == text;
+		}
+
+		return (value.m_type == value_type::string || value.m_type == value_type::literal) && value.m_text == text;
+	}
+
+	// Position of the segment target inside the m_items of current.
+	static std::optional<size_t> find_child(const value& current, const path_segment& segment)
+	{
+		switch (segment.m_kind)
+		{
+		case path_segment::kind::key:
+		{
+			if (current.m_type == value_type::object)
+			{
+				const auto it = std::ranges::find(current.m_keys, segment.m_key);
+				if (it != current.m_keys.end())
+				{
+					return it - current.m_keys.begin();
+				}
+			}
+			break;
+		}
+		case path_segment::kind::index:
+		{
+			if (current.m_type == value_type::array && segment.m_index < current.m_items.size())
+			{
+				return segment.m_index;
+			}
+			break;
+		}
+		case path_segment::kind::match:
+		{
+			if (current.m_type == value_type::array)
+			{
+				for (size_t i = 0; i < current.m_items.size(); i++)
+				{
+					const auto field = current.m_items[i].find_key(segment.m_key);
+					if (field && text_equals(*field, segment.m_match_value))
+					{
+						return i;
+					}
+				}
+			}
+			break;
+		}
+		}
+
+		return std::nullopt;
+	}
+
+	// Follows every segment of the span, plain object keys are created along the way when create_missing is set.
+	// Nothing gets created unless the whole span can be followed: every segment from the first missing one on must be a key.
+	static value* walk(value& root, std::span<const path_segment> segments, bool create_missing)
+	{
+		auto current = &root;
+		for (size_t i = 0; i < segments.size(); i++)
+		{
+			const auto& segment = segments[i];
+			if (const auto index = find_child(*current, segment))
+			{
+				current = &current->m_items[*index];
+				continue;
+			}
+
+			const auto is_key = [](const path_segment& remaining_segment)
+			{
+				return remaining_segment.m_kind == path_segment::kind::key;
+			};
+			if (!create_missing || current->m_type != value_type::object || !std::ranges::all_of(segments.subspan(i), is_key))
+			{
+				return nullptr;
+			}
+
+			// Freshly created objects have none of the remaining keys.
+			for (const auto& missing_segment : segments.subspan(i))
+			{
+				current->m_keys.emplace_back(missing_segment.m_key);
+				current         = &current->m_items.emplace_back();
+				current->m_type = value_type::object;
+			}
+			break;
+		}
+
+		return current;
+	}
+
+	std::vector<size_t> locate(const value& root, std::string_view path, bool& is_complete)
+	{
+		std::vector<size_t> res;
+		is_complete = false;
+
+		const auto segments = parse_path(path);
+		if (!segments)
+		{
+			return res;
+		}
+
+		auto current = &root;
+		for (const auto& segment : *segments)
+		{
+			const auto index = find_child(*current, segment);
+			if (!index)
+			{
+				return res;
+			}
+
+			res.push_back(*index);
+			current = &current->m_items[*index];
+		}
+
+		is_complete = true;
+		return res;
+	}
+
+	value& at(value& root, std::span<const size_t> location)
+	{
+		auto current = &root;
+		for (const auto index : location)
+		{
+			current = &current->m_items[index];
+		}
+
+		return *current;
+	}
+
+	bool is_addressable_key(std::string_view key)
+	{
+		return !key.empty() && key.find_first_of(".[]=") == std::string_view::npos;
+	}
+
+	// The Name of the item if it can be used as a [Name=...] selector that only picks that item.
+	static std::optional<std::string> get_unique_name(const value& array, size_t index)
+	{
+		const auto name = array.m_items[index].find_key("Name");
+		if (!name || (name->m_type != value_type::string && name->m_type != value_type::literal))
+		{
+			return std::nullopt;
+		}
+
+		auto res = name->get_decoded_text();
+		if (res.contains(']'))
+		{
+			return std::nullopt;
+		}
+
+		// A match selector picks the first item with that name.
+		for (size_t i = 0; i < index; i++)
+		{
+			const auto other = array.m_items[i].find_key("Name");
+			if (other && text_equals(*other, res))
+			{
+				return std::nullopt;
+			}
+		}
+
+		return res;
+	}
+
+	std::string get_canonical_path(const value& root, std::span<const size_t> location)
+	{
+		std::string res;
+
+		auto current = &root;
+		for (const auto index : location)
+		{
+			if (current->m_type == value_type::object)
+			{
+				if (!res.empty())
+				{
+					res += '.';
+				}
+				res += current->m_keys[index];
+			}
+			else if (const auto name = get_unique_name(*current, index))
+			{
+				res += std::format("[Name={}]", *name);
+			}
+			else
+			{
+				res += std::format("[{}]", index + 1);
+			}
+
+			current = &current->m_items[index];
+		}
+
+		return res;
+	}
+
+	value* find(value& root, std::string_view path)
+	{
+		const auto segments = parse_path(path);
+		return segments ? walk(root, *segments, false) : nullptr;
+	}
+
+	bool set(value& root, std::string_view path, value new_value)
+	{
+		const auto segments = parse_path(path);
+		if (!segments)
+		{
+			return false;
+		}
+
+		// A missing last key is created as an empty object first, then replaced.
+		const auto target = walk(root, *segments, true);
+		if (!target)
+		{
+			return false;
+		}
+
+		*target = std::move(new_value);
+		return true;
+	}
+
+	bool insert(value& root, std::string_view path, value new_value, std::optional<size_t> index)
+	{
+		const auto array = find(root, path);
+		if (!array || array->m_type != value_type::array)
+		{
+			return false;
+		}
+
+		if (!index)
+		{
+			array->m_items.push_back(std::move(new_value));
+			return true;
+		}
+
+		if (*index == 0 || *index > array->m_items.size() + 1)
+		{
+			return false;
+		}
+
+		array->m_items.insert(array->m_items.begin() + (*index - 1), std::move(new_value));
+		return true;
+	}
+
+	bool remove(value& root, std::string_view path)
+	{
+		const auto segments = parse_path(path);
+		if (!segments)
+		{
+			return false;
+		}
+
+		const auto parent = walk(root, std::span(*segments).first(segments->size() - 1), false);
+		if (!parent)
+		{
+			return false;
+		}
+
+		const auto index = find_child(*parent, segments->back());
+		if (!index)
+		{
+			return false;
+		}
+
+		if (parent->m_type == value_type::object)
+		{
+			parent->m_keys.erase(parent->m_keys.begin() + *index);
+		}
+		parent->m_items.erase(parent->m_items.begin() + *index);
+		return true;
+	}
+} // namespace big::sjson
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <span>
+
+namespace big::sjson
+{
+	enum class value_type : uint8_t
+	{
+		null,
+		boolean,
+		// Numbers and any other unquoted word, kept as written.
+		literal,
+		string,
+		array,
+		object,
+	};
+
+	struct value
+	{
+		value_type m_type = value_type::null;
+		bool m_boolean    = false;
+		// Literals and strings as they appear in the file, escape sequences included.
+		std::string m_text;
+		// String delimited by """, its text never holds escape sequences.
+		bool m_is_multiline = false;
+		// Array items, or object values.
+		std::vector<value> m_items;
+		// Object keys, in file order and parallel to m_items.
+		std::vector<std::string> m_keys;
+
+		bool operator==(const value&) const = default;
+
+		static value make_string(std::string_view decoded);
+
+		value* find_key(std::string_view key);
+		const value* find_key(std::string_view key) const;
+
+		// Content of a string with its escape sequences resolved, or the text of a literal.
+		std::string get_decoded_text() const;
+	};
+
+	struct document
+	{
+		value m_root;
+		// Most game files wrap their root object in braces, some don't.
+		bool m_has_root_braces = true;
+	};
+
+	// Stingray flavored JSON: keys may be unquoted, `=` and `:` are both accepted, commas are optional,
+	// strings may be """ delimited and span lines, the root object braces may be omitted.
+	// Comments are dropped. On failure the error holds the line and column of the offending character.
+	std::optional<document> parse(std::string_view text, std::string* error = nullptr);
+
+	// Tab indented, one `key = value` per line.
+	std::string serialize(const document& document, size_t size_hint = 0);
+
+	// Paths are dot separated object keys, each optionally followed by array selectors:
+	// `Animations[3]` is the third item (1-based, as in Lua) and `Animations[Name=Foo]` the first object item whose Name is Foo.
+	// Keys and selector values that hold `.`, `[`, `]` or `=` can't be addressed.
+	value* find(value& root, std::string_view path);
+
+	// Replaces the value at the given path. The last object key and the intermediate plain object keys are created when missing.
+	bool set(value& root, std::string_view path, value new_value);
+
+	// The path has to point to an array, index is 1-based. Appends without an index.
+	bool insert(value& root, std::string_view path, value new_value, std::optional<size_t> index = std::nullopt);
+
+	bool remove(value& root, std::string_view path);
+
+	// Positions inside m_items, from the root, of the values the path goes through.
+	// Stops at the first segment that doesn't resolve, is_complete tells whether all of them did.
+	std::vector<size_t> locate(const value& root, std::string_view path, bool& is_complete);
+
+	value& at(value& root, std::span<const size_t> location);
+
+	// Path of a located value that keeps pointing to it when items get added to or removed from the arrays on the way:
+	// array items are addressed by their Name when it is unique within the array, by their position otherwise.
+	std::string get_canonical_path(const value& root, std::span<const size_t> location);
+
+	// Whether the key can be written in a path.
+	bool is_addressable_key(std::string_view key);
+} // namespace big::sjson
@@ -0,0 +1,73 @@
+#include "parallel_jobs.hpp"
+
+namespace big
+{
+	void run_parallel_jobs(size_t job_count, size_t worker_count, const spawn_worker_t& spawn_worker, std::function<void(size_t job)> run_job, const std::function<void()>& on_progress)
+	{
+		if (!job_count)
+		{
+			return;
+		}
+
+		// Late workers may only start once the caller already returned, everything they touch before claiming a job lives here.
+		struct shared_state
+		{
+			std::atomic<size_t> m_next_job{0};
+			std::atomic<size_t> m_done_jobs{0};
+			size_t m_job_count      = 0;
+			bool m_notify_every_job = false;
+			std::function<void(size_t)> m_run_job;
+		};
+
+		auto state                = std::make_shared<shared_state>();
+		state->m_job_count        = job_count;
+		state->m_notify_every_job = static_cast<bool>(on_progress);
+		state->m_run_job          = std::move(run_job);
+
+		const auto run_jobs = [](shared_state& state, const std::function<void()>& after_job)
+		{
+			while (true)
+			{
+				const auto job = state.m_next_job++;
+				if (job >= state.m_job_count)
+				{
+					return;
+				}
+
+				state.m_run_job(job);
+
+				// Every job rather than the last one only when the caller reports progress as they go.
+				if (++state.m_done_jobs == state.m_job_count || state.m_notify_every_job)
+				{
+					state.m_done_jobs.notify_all();
+				}
+
+				if (after_job)
+				{
+					after_job();
+				}
+			}
+		};
+
+		worker_count = std::clamp<size_t>(worker_count, 1, job_count);
+		for (size_t i = 1; i < worker_count; i++)
+		{
+			spawn_worker(
+			    [state, run_jobs]()
+			    {
+				    run_jobs(*state, {});
+			    });
+		}
+
+		run_jobs(*state, on_progress);
+
+		for (auto done = state->m_done_jobs.load(); done != job_count; done = state->m_done_jobs.load())
+		{
+			state->m_done_jobs.wait(done);
+			if (on_progress)
+			{
+				on_progress();
+			}
+		}
+	}
+} // namespace big
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace big
+{
+	// Hands a function to run to another thread, e.g. by pushing it to the thread pool.
+	using spawn_worker_t = std::function<void(std::function<void()>)>;
+
+	// Runs run_job(job) for every job in [0, job_count) and returns once all of them are done.
+	// Workers claim the next job from a shared counter until there is none left: the calling thread is one of them,
+	// spawn_worker gets called for the other worker_count - 1, so this returns even if no spawned worker ever gets to run.
+	// Spawned workers may only start once this returned, they then find no job left and run_job doesn't get called anymore.
+	// on_progress is only ever called from the calling thread, after each of its own jobs and whenever another worker finishes one.
+	// Must not be called while holding the loader lock.
+	void run_parallel_jobs(size_t job_count, size_t worker_count, const spawn_worker_t& spawn_worker, std::function<void(size_t job)> run_job, const std::function<void()>& on_progress = {});
+} // namespace big